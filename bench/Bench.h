@@ -0,0 +1,116 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if defined( __GNUC__ )
+#define BENCH_NOINLINE __attribute__( ( noinline ) )
+#else
+#define BENCH_NOINLINE
+#endif
+
+/** \brief Helpers shared by the benchmark drivers.
+ *  Drivers take their sizes from the command line, time with
+ *  steady_clock and print plain text tables, so a run is easy to repeat
+ *  and compare.  Inputs come from a fixed seed, the same on every
+ *  platform.  Build with -DCMAKE_BUILD_TYPE=Release, the numbers in the
+ *  history are at -O2.
+ */
+namespace Bench
+{
+	typedef std::chrono::steady_clock Clock;
+
+	/// Nanoseconds since start
+	inline double elapsed( Clock::time_point start )
+	{
+		return std::chrono::duration< double, std::nano >( Clock::now() - start ).count();
+	}
+
+	/// Command line argument at position as a number, fallback when it is missing
+	inline std::size_t argument( int argc, char ** argv, int position, std::size_t fallback )
+	{
+		return position < argc ? static_cast< std::size_t >( std::strtoull( argv[position], nullptr, 10 ) ) : fallback;
+	}
+
+	/// xorshift64*, small and the same everywhere
+	class Random
+	{
+	public:
+		explicit Random( std::uint64_t seed ) : m_state( seed != 0 ? seed : 1 ) {}
+
+		std::uint64_t next()
+		{
+			m_state ^= m_state >> 12;
+			m_state ^= m_state << 25;
+			m_state ^= m_state >> 27;
+
+			return m_state * 0x2545F4914F6CDD1Dull;
+		}
+
+		/// Uniform below bound, bound is not 0
+		std::size_t below( std::size_t bound ) { return static_cast< std::size_t >( next() % bound ); }
+
+	private:
+		std::uint64_t m_state;
+	};
+
+	/// count distinct "<prefix>/Component/Mesh_<n>.material" names, about 35 characters
+	inline std::vector< std::string > names( std::size_t count, std::string const & prefix )
+	{
+		std::vector< std::string > result( count );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			result[i] = prefix + "/Component/Mesh_" + std::to_string( i ) + ".material";
+		}
+
+		return result;
+	}
+
+	/// count random printable strings with lengths from min_length to max_length
+	inline std::vector< std::string > randomStrings( std::size_t count, std::size_t min_length, std::size_t max_length, std::uint64_t seed )
+	{
+		Random random( seed );
+		std::vector< std::string > result( count );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			std::size_t const length = min_length + random.below( max_length - min_length + 1 );
+
+			result[i].resize( length );
+
+			for ( std::size_t c = 0; c < length; ++c )
+			{
+				result[i][c] = static_cast< char >( ' ' + random.below( 95 ) );
+			}
+		}
+
+		return result;
+	}
+
+	/// Fisher-Yates with Random, so the order is the same on every run
+	template < typename T >
+	void shuffle( std::vector< T > & values, Random & random )
+	{
+		for ( std::size_t i = values.size(); i > 1; --i )
+		{
+			std::swap( values[ i - 1 ], values[ random.below( i ) ] );
+		}
+	}
+
+	/// Value at fraction p of sorted values, p from 0 to 1
+	inline double percentile( std::vector< double > const & sorted, double p )
+	{
+		std::size_t const at = static_cast< std::size_t >( p * ( sorted.size() - 1 ) );
+
+		return sorted.empty() ? 0.0 : sorted[at];
+	}
+}
+
+#endif
@@ -0,0 +1,122 @@
+/** \brief Lookups in an InternTable before and after freeze().
+ *  For each size, interns that many names into a table of its own, then
+ *  looks them up in random order by id, by text ( hashing included ) and
+ *  for ids that are not interned, once mutable and once frozen.  Also
+ *  prints how long freeze() and reclaim() took and bytesReserved() on
+ *  either side.
+ *
+ *  Usage: FreezeBench [count...], defaults to 1000 10000 100000 1000000
+ */
+
+#include "Bench.h"
+#include "InternTable.h"
+
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+	/// ns per lookup by id, by text and of absent ids
+	void measure( InternTable const & table, StringIndex const & index, std::vector< std::string > const & names,
+		std::vector< StringID > const & ids, std::vector< StringID > const & absent, std::vector< std::size_t > const & order,
+		double * ns, std::size_t & checksum )
+	{
+		Bench::Clock::time_point start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < order.size(); ++i )
+		{
+			checksum += table.find( ids[ order[i] ] );
+		}
+
+		ns[0] = Bench::elapsed( start ) / order.size();
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < order.size(); ++i )
+		{
+			std::string const & name = names[ order[i] ];
+			StringID id = StringHash::hash( name.data(), name.size() );
+
+			checksum += table.find( index, id, name.data(), name.size() );
+		}
+
+		ns[1] = Bench::elapsed( start ) / order.size();
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < order.size(); ++i )
+		{
+			checksum += table.find( absent[ order[i] ] );
+		}
+
+		ns[2] = Bench::elapsed( start ) / order.size();
+	}
+}
+
+int main( int argc, char ** argv )
+{
+	std::vector< std::size_t > counts;
+
+	for ( int i = 1; i < argc; ++i )
+	{
+		counts.push_back( Bench::argument( argc, argv, i, 0 ) );
+	}
+
+	if ( counts.empty() )
+	{
+		counts.push_back( 1000 );
+		counts.push_back( 10000 );
+		counts.push_back( 100000 );
+		counts.push_back( 1000000 );
+	}
+
+	std::printf( "%9s  %21s  %21s  %21s  %10s  %17s\n", "strings", "by id ns mut/frozen", "by text ns mut/frozen",
+		"miss ns mut/frozen", "freeze ms", "MB before/after" );
+
+	std::size_t checksum = 0;
+
+	for ( std::size_t c = 0; c < counts.size(); ++c )
+	{
+		std::size_t const count = counts[c];
+		std::vector< std::string > const names = Bench::names( count, "Freeze" );
+		std::vector< StringID > ids( count );
+		std::vector< StringID > absent( count );
+		std::vector< std::size_t > order( count );
+
+		std::unique_ptr< StringIndex > index( new StringIndex( "", 0 ) );
+		std::unique_ptr< InternTable > table( new InternTable() );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			std::string const absent_name = "Absent" + names[i];
+
+			ids[i] = StringHash::hash( names[i].data(), names[i].size() );
+			table->insert( *index, ids[i], names[i].data(), names[i].size() );
+			absent[i] = StringHash::hash( absent_name.data(), absent_name.size() );
+			order[i] = i;
+		}
+
+		Bench::Random random( 1 + c );
+		Bench::shuffle( order, random );
+
+		double mutable_ns[3], frozen_ns[3];
+		measure( *table, *index, names, ids, absent, order, mutable_ns, checksum );
+
+		double const bytes_before = static_cast< double >( table->bytesReserved() );
+		Bench::Clock::time_point const start = Bench::Clock::now();
+
+		table->freeze();
+		table->reclaim();
+
+		double const freeze_ms = Bench::elapsed( start ) / 1e6;
+		double const bytes_after = static_cast< double >( table->bytesReserved() );
+
+		measure( *table, *index, names, ids, absent, order, frozen_ns, checksum );
+
+		std::printf( "%9zu  %9.1f / %9.1f  %9.1f / %9.1f  %9.1f / %9.1f  %10.2f  %7.1f / %7.1f\n", count,
+			mutable_ns[0], frozen_ns[0], mutable_ns[1], frozen_ns[1], mutable_ns[2], frozen_ns[2],
+			freeze_ms, bytes_before / 1e6, bytes_after / 1e6 );
+	}
+
+	std::printf( "checksum %zu\n", checksum );
+
+	return 0;
+}
@@ -0,0 +1,51 @@
+/** \brief Latency of each insert while the intern table grows.
+ *  Interns count new names one at a time, timing every insert, and
+ *  prints the latency percentiles and HashString::getGrowthStats().
+ *  With a non zero reserve argument it calls HashString::reserve( count )
+ *  first, or set HASH_STRING_CAPACITY to size the table on first use.
+ *
+ *  Usage: GrowthBench [count] [reserve], defaults to 2000000 0
+ */
+
+#include "Bench.h"
+#include "HashString.h"
+
+#include <cstdio>
+
+int main( int argc, char ** argv )
+{
+	std::size_t const count = Bench::argument( argc, argv, 1, 2000000 );
+	bool const reserve = Bench::argument( argc, argv, 2, 0 ) != 0;
+
+	std::vector< std::string > const names = Bench::names( count, "Growth" );
+	std::vector< double > latencies( count );
+	std::size_t checksum = 0;
+
+	if ( reserve )
+	{
+		HashString::reserve( count );
+	}
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		Bench::Clock::time_point const start = Bench::Clock::now();
+
+		checksum += HashString::internString( names[i] );
+		latencies[i] = Bench::elapsed( start );
+	}
+
+	std::sort( latencies.begin(), latencies.end() );
+
+	HashString::GrowthStats const stats = HashString::getGrowthStats();
+
+	std::printf( "%zu inserts%s, us\n", count, reserve ? " after reserve()" : "" );
+	std::printf( "p50 %.2f  p99 %.2f  p999 %.2f  p9999 %.2f  max %.1f\n",
+		Bench::percentile( latencies, 0.5 ) / 1e3, Bench::percentile( latencies, 0.99 ) / 1e3,
+		Bench::percentile( latencies, 0.999 ) / 1e3, Bench::percentile( latencies, 0.9999 ) / 1e3,
+		latencies.back() / 1e3 );
+	std::printf( "growths %zu, %.2f ms growing, longest %.3f ms\n",
+		stats.m_count, stats.m_nanoseconds / 1e6, stats.m_maxNanoseconds / 1e6 );
+	std::printf( "checksum %zu\n", checksum );
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+/** \brief Copying, scanning and sorting HashString handles.
+ *  Compared with VirtualHandle, the layout HashString had before it was
+ *  made trivially copyable: a virtual destructor, a user written copy
+ *  and out of line comparisons.
+ *
+ *  Usage: HandleBench [handles] [names], defaults to 10000000 4096
+ */
+
+#include "Bench.h"
+#include "HashString.h"
+
+#include <cstdio>
+
+namespace
+{
+	/// A text pointer and an id behind a vptr
+	class VirtualHandle
+	{
+	public:
+		VirtualHandle() : m_string( nullptr ), m_hashValue( 0 ) {}
+		VirtualHandle( char const * string, StringID hash_value ) : m_string( string ), m_hashValue( hash_value ) {}
+		VirtualHandle( VirtualHandle const & other ) : m_string( other.m_string ), m_hashValue( other.m_hashValue ) {}
+		virtual ~VirtualHandle() {}
+
+		VirtualHandle & operator=( VirtualHandle const & other )
+		{
+			m_string = other.m_string;
+			m_hashValue = other.m_hashValue;
+
+			return *this;
+		}
+
+		BENCH_NOINLINE bool operator==( VirtualHandle const & other ) const { return m_hashValue == other.m_hashValue; }
+		BENCH_NOINLINE bool operator<( VirtualHandle const & other ) const { return m_hashValue < other.m_hashValue; }
+
+	private:
+		char const * m_string;
+		StringID m_hashValue;
+	};
+
+	/// Copy, scan and sort ms of handles
+	template < typename Handle >
+	void measure( char const * label, std::vector< Handle > const & handles )
+	{
+		Bench::Clock::time_point start = Bench::Clock::now();
+		std::vector< Handle > copy( handles );
+		double const copy_ms = Bench::elapsed( start ) / 1e6;
+
+		start = Bench::Clock::now();
+		std::size_t matches = 0;
+
+		for ( std::size_t i = 0; i < copy.size(); ++i )
+		{
+			matches += copy[i] == handles[0];
+		}
+
+		double const scan_ms = Bench::elapsed( start ) / 1e6;
+
+		start = Bench::Clock::now();
+		std::sort( copy.begin(), copy.end() );
+		double const sort_ms = Bench::elapsed( start ) / 1e6;
+
+		std::printf( "%-20s %3zu bytes  %8.1f  %8.1f  %8.1f  (%zu matches)\n", label, sizeof( Handle ), copy_ms, scan_ms, sort_ms, matches );
+	}
+}
+
+int main( int argc, char ** argv )
+{
+	std::size_t const count = Bench::argument( argc, argv, 1, 10000000 );
+	std::size_t const name_count = Bench::argument( argc, argv, 2, 4096 );
+
+	std::vector< std::string > const names = Bench::names( name_count, "Handle" );
+	std::vector< HashString > interned( name_count );
+
+	for ( std::size_t i = 0; i < name_count; ++i )
+	{
+		interned[i] = HashString( names[i] );
+	}
+
+	Bench::Random random( 1 );
+	std::vector< HashString > handles( count );
+	std::vector< VirtualHandle > virtual_handles( count );
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		HashString const & picked = interned[ random.below( name_count ) ];
+
+		handles[i] = picked;
+		virtual_handles[i] = VirtualHandle( picked.getCString(), picked.getHashValue() );
+	}
+
+	std::printf( "%zu handles over %zu names, ms\n", count, name_count );
+	std::printf( "%-20s %9s  %8s  %8s  %8s\n", "layout", "", "copy", "scan", "sort" );
+	measure( "VirtualHandle", virtual_handles );
+	measure( "HashString", handles );
+
+	return 0;
+}
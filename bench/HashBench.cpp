@@ -0,0 +1,137 @@
+/** \brief StringHash::hash() over a batch against one call per string, and the hash policy's cost and collisions.
+ *  Random strings in a few length bands, then uniform 200 character
+ *  strings for a per byte figure.  Also counts ids where the two differ,
+ *  which must be 0.
+ *
+ *  Then, for the HASH_STRING_HASH policy built in: ns per byte of one
+ *  call per string at lengths 8, 32, 128 and 1024, and the ids shared
+ *  by more than one of the "Entity/Component/Mesh_<n>.material" names,
+ *  next to what a random function would give.  Built as HashBench with
+ *  the top level options, and as HashBenchFnv1a, HashBenchXxHash32,
+ *  HashBenchXxHash64 and HashBenchCrc32c, so one build compares them.
+ *
+ *  Usage: HashBench [count] [rounds] [names], defaults to 200000 5 1000000
+ */
+
+#include "Bench.h"
+#include "StringHash.h"
+
+#include <cstdio>
+
+namespace
+{
+#if HASH_STRING_HASH == HASH_STRING_HASH_XXHASH
+	char const * const kPolicy = HASH_STRING_ID_BITS == 64 ? "XXH64" : "XXH32";
+#elif HASH_STRING_HASH == HASH_STRING_HASH_CRC32C
+	char const * const kPolicy = "CRC32C";
+#else
+	char const * const kPolicy = HASH_STRING_ID_BITS == 64 ? "FNV-1a 64" : "FNV-1a 32";
+#endif
+
+	/// Strings that share their id with an earlier one
+	std::size_t collisions( std::vector< std::string > const & strs )
+	{
+		std::vector< StringID > ids( strs.size() );
+
+		for ( std::size_t i = 0; i < strs.size(); ++i )
+		{
+			ids[i] = StringHash::hash( strs[i].data(), strs[i].size() );
+		}
+
+		std::sort( ids.begin(), ids.end() );
+
+		return static_cast< std::size_t >( ids.end() - std::unique( ids.begin(), ids.end() ) );
+	}
+
+	/// Best ns per string of each way of hashing strs
+	void measure( std::vector< std::string > const & strs, std::size_t rounds, double & scalar_ns, double & batch_ns, std::size_t & mismatches )
+	{
+		std::size_t const count = strs.size();
+		std::vector< char const * > pointers( count );
+		std::vector< std::size_t > lengths( count );
+		std::vector< StringID > scalar_ids( count );
+		std::vector< StringID > batch_ids( count );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			pointers[i] = strs[i].data();
+			lengths[i] = strs[i].size();
+		}
+
+		scalar_ns = 1e300;
+		batch_ns = 1e300;
+
+		for ( std::size_t r = 0; r < rounds; ++r )
+		{
+			Bench::Clock::time_point start = Bench::Clock::now();
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				scalar_ids[i] = StringHash::hash( pointers[i], lengths[i] );
+			}
+
+			scalar_ns = std::min( scalar_ns, Bench::elapsed( start ) / count );
+			start = Bench::Clock::now();
+
+			StringHash::hash( pointers.data(), lengths.data(), count, batch_ids.data() );
+
+			batch_ns = std::min( batch_ns, Bench::elapsed( start ) / count );
+		}
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			mismatches += scalar_ids[i] != batch_ids[i];
+		}
+	}
+}
+
+int main( int argc, char ** argv )
+{
+	std::size_t const count = Bench::argument( argc, argv, 1, 200000 );
+	std::size_t const rounds = Bench::argument( argc, argv, 2, 5 );
+	std::size_t const name_count = Bench::argument( argc, argv, 3, 1000000 );
+
+	std::printf( "%s ids\n", kPolicy );
+
+	std::size_t const bands[][2] = { { 4, 16 }, { 16, 64 }, { 64, 256 } };
+	std::size_t mismatches = 0;
+
+	std::printf( "%10s  %10s  %10s  ns per string\n", "length", "scalar", "batch" );
+
+	for ( std::size_t b = 0; b < sizeof( bands ) / sizeof( bands[0] ); ++b )
+	{
+		double scalar_ns, batch_ns;
+		measure( Bench::randomStrings( count, bands[b][0], bands[b][1], 1 + b ), rounds, scalar_ns, batch_ns, mismatches );
+
+		std::printf( "%4zu - %3zu  %10.1f  %10.1f\n", bands[b][0], bands[b][1], scalar_ns, batch_ns );
+	}
+
+	double scalar_ns, batch_ns;
+	measure( Bench::randomStrings( count, 200, 200, 7 ), rounds, scalar_ns, batch_ns, mismatches );
+
+	std::printf( "uniform 200: %.2f ns per byte scalar, %.2f batch\n", scalar_ns / 200, batch_ns / 200 );
+
+	std::size_t const lengths[] = { 8, 32, 128, 1024 };
+
+	std::printf( "one call per string, ns per byte:" );
+
+	for ( std::size_t l = 0; l < sizeof( lengths ) / sizeof( lengths[0] ); ++l )
+	{
+		// About the same number of bytes at every length
+		std::size_t const strings = std::max< std::size_t >( count * 32 / lengths[l], 1000 );
+
+		measure( Bench::randomStrings( strings, lengths[l], lengths[l], 11 + l ), rounds, scalar_ns, batch_ns, mismatches );
+
+		std::printf( "  %zu: %.3f", lengths[l], scalar_ns / lengths[l] );
+	}
+
+	// n ( n - 1 ) / 2 pairs, each sharing an id with chance 2^-bits
+	double const pairs = 0.5 * static_cast< double >( name_count ) * static_cast< double >( name_count - 1 );
+	double const expected = pairs / ( HASH_STRING_ID_BITS == 64 ? 18446744073709551616.0 : 4294967296.0 );
+
+	std::printf( "\ncollisions over %zu names: %zu ( %.1f expected from a random function )\n",
+		name_count, collisions( Bench::names( name_count, "Entity" ) ), expected );
+	std::printf( "mismatches %zu\n", mismatches );
+
+	return mismatches == 0 ? 0 : 1;
+}
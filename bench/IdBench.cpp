@@ -0,0 +1,79 @@
+/** \brief What the StringID width costs and buys, over one name corpus.
+ *  Hashes count "Entity/Component/Mesh_<n>.material" names and reports
+ *  the ids shared by more than one name, the intern table's
+ *  bytesReserved() per name once they are all inserted, ns per id to
+ *  scan the ids for one of them, and ms to sort them.
+ *
+ *  Built as IdBench32 and IdBench64, with HASH_STRING_ID_BITS 32 and 64,
+ *  so one build compares them.
+ *
+ *  Usage: IdBench<bits> [count] [rounds], defaults to 1000000 5
+ */
+
+#include "Bench.h"
+#include "InternTable.h"
+
+#include <cstdio>
+#include <memory>
+
+int main( int argc, char ** argv )
+{
+	std::size_t const count = Bench::argument( argc, argv, 1, 1000000 );
+	std::size_t const rounds = Bench::argument( argc, argv, 2, 5 );
+
+	std::vector< std::string > const names = Bench::names( count, "Entity" );
+	std::vector< StringID > ids( count );
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		ids[i] = StringHash::hash( names[i].data(), names[i].size() );
+	}
+
+	std::vector< StringID > sorted( ids );
+	std::sort( sorted.begin(), sorted.end() );
+
+	std::size_t const collisions = static_cast< std::size_t >( sorted.end() - std::unique( sorted.begin(), sorted.end() ) );
+
+	// Without collision resolution a name that shares an id is not added, the bytes are per name inserted
+	std::unique_ptr< StringIndex > index( new StringIndex( "", 0 ) );
+	std::unique_ptr< InternTable > table( new InternTable() );
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		StringID id = ids[i];
+		table->insert( *index, id, names[i].data(), names[i].size() );
+	}
+
+	double const bytes = static_cast< double >( table->bytesReserved() ) / table->size();
+
+	double best_scan = 1e300, best_sort = 1e300;
+	std::size_t checksum = 0;
+
+	for ( std::size_t r = 0; r < rounds; ++r )
+	{
+		StringID const target = ids[ ( r + 1 ) * count / ( rounds + 1 ) ];
+
+		Bench::Clock::time_point start = Bench::Clock::now();
+
+		checksum += static_cast< std::size_t >( std::count( ids.begin(), ids.end(), target ) );
+
+		best_scan = std::min( best_scan, Bench::elapsed( start ) / count );
+
+		sorted = ids;
+		start = Bench::Clock::now();
+
+		std::sort( sorted.begin(), sorted.end() );
+
+		best_sort = std::min( best_sort, Bench::elapsed( start ) / 1e6 );
+		checksum += static_cast< std::size_t >( sorted[ count / 2 ] );
+	}
+
+	std::printf( "%d bit ids, %zu names, best of %zu\n", HASH_STRING_ID_BITS, count, rounds );
+	std::printf( "collisions          %10zu\n", collisions );
+	std::printf( "table bytes / name  %10.1f\n", bytes );
+	std::printf( "scan ns / id        %10.2f\n", best_scan );
+	std::printf( "sort ms             %10.1f\n", best_sort );
+	std::printf( "checksum %zu\n", checksum );
+
+	return 0;
+}
@@ -0,0 +1,205 @@
+/** \brief Hit and miss paths of interning, one string at a time and in batches.
+ *  miss: internString( std::string ) of a name not interned yet
+ *  hit: HashString( std::string ) of an interned name
+ *  lookup miss: tryFind() of a name that is never interned
+ *  find: tryFind() over names half interned, half not, in random order,
+ *  against the two call isStringInterned() then HashString( StringID )
+ *  it replaces, which hashes and probes twice on a hit
+ *  batch: count new names through internString() one at a time, then
+ *  another count through one internStrings() call
+ *
+ *  The intern table is global, so every round uses names of its own and
+ *  the table keeps growing from round to round.  Best of rounds.
+ *
+ *  Also counts operator new calls per name over the miss and hit loops,
+ *  0 but for the arena's page now and then, since interning copies into
+ *  the arena rather than allocating per string.
+ *
+ *  With HASH_STRING_RESOLVE_COLLISIONS, also the check hash per name.
+ *  InternBenchUnseeded and InternBenchSeeded build it with collision
+ *  resolution, without and with HASH_STRING_SEEDED, for what seeding
+ *  costs, and InternBenchId32 and InternBenchId64 with each id width.
+ *
+ *  Usage: InternBench [count] [rounds], defaults to 1000000 3
+ */
+
+#include "Bench.h"
+#include "HashString.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic< std::size_t > s_allocations( 0 );
+}
+
+void * operator new( std::size_t bytes )
+{
+	s_allocations.fetch_add( 1, std::memory_order_relaxed );
+
+	void * block = std::malloc( bytes != 0 ? bytes : 1 );
+
+	if ( block == nullptr )
+	{
+		throw std::bad_alloc();
+	}
+
+	return block;
+}
+
+void * operator new[]( std::size_t bytes )
+{
+	return operator new( bytes );
+}
+
+void operator delete( void * block ) noexcept
+{
+	std::free( block );
+}
+
+void operator delete[]( void * block ) noexcept
+{
+	std::free( block );
+}
+
+int main( int argc, char ** argv )
+{
+	std::size_t const count = Bench::argument( argc, argv, 1, 1000000 );
+	std::size_t const rounds = Bench::argument( argc, argv, 2, 3 );
+
+	double best_miss = 1e300, best_hit = 1e300, best_lookup_miss = 1e300;
+	double best_try_find = 1e300, best_two_calls = 1e300;
+	double best_loop = 1e300, best_batch = 1e300;
+	std::size_t miss_allocations = 0, hit_allocations = 0;
+	std::size_t checksum = 0;
+
+	for ( std::size_t r = 0; r < rounds; ++r )
+	{
+		std::string const round = std::to_string( r );
+		std::vector< std::string > const fresh = Bench::names( count, "Round" + round );
+		std::vector< std::string > const absent = Bench::names( count, "Absent" + round );
+
+		std::size_t allocations = s_allocations.load( std::memory_order_relaxed );
+		Bench::Clock::time_point start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			checksum += HashString::internString( fresh[i] );
+		}
+
+		best_miss = std::min( best_miss, Bench::elapsed( start ) / count );
+		miss_allocations += s_allocations.load( std::memory_order_relaxed ) - allocations;
+		allocations = s_allocations.load( std::memory_order_relaxed );
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			checksum += HashString( fresh[i] ).getIndex();
+		}
+
+		best_hit = std::min( best_hit, Bench::elapsed( start ) / count );
+		hit_allocations += s_allocations.load( std::memory_order_relaxed ) - allocations;
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			HashString found;
+			checksum += HashString::tryFind( absent[i], found );
+		}
+
+		best_lookup_miss = std::min( best_lookup_miss, Bench::elapsed( start ) / count );
+
+		// Same inputs for both ways of finding
+		std::vector< std::string const * > probes( count );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			probes[i] = i % 2 == 0 ? &fresh[i] : &absent[i];
+		}
+
+		Bench::Random random( 1 + r );
+		Bench::shuffle( probes, random );
+
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			HashString found;
+
+			if ( HashString::tryFind( *probes[i], found ) )
+			{
+				checksum += found.getIndex();
+			}
+		}
+
+		best_try_find = std::min( best_try_find, Bench::elapsed( start ) / count );
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			std::string const & probe = *probes[i];
+
+			if ( HashString::isStringInterned( probe ) )
+			{
+				checksum += HashString( StringHash::hash( probe.data(), probe.size() ) ).getIndex();
+			}
+		}
+
+		best_two_calls = std::min( best_two_calls, Bench::elapsed( start ) / count );
+
+		std::vector< std::string > const looped = Bench::names( count, "Loop" + round );
+		std::vector< std::string > const batched = Bench::names( count, "Batch" + round );
+		std::vector< StringID > ids( count );
+
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ids[i] = HashString::internString( looped[i] );
+		}
+
+		best_loop = std::min( best_loop, Bench::elapsed( start ) );
+		start = Bench::Clock::now();
+
+		HashString::internStrings( batched.data(), count, ids.data() );
+
+		best_batch = std::min( best_batch, Bench::elapsed( start ) );
+		checksum += ids[ count / 2 ];
+	}
+
+#if HASH_STRING_RESOLVE_COLLISIONS
+	// What seeding changes per name: SipHash-1-3 under the key instead of the unseeded check hash
+	std::vector< std::string > const checked = Bench::names( count, "Check" );
+	double best_check = 1e300;
+
+	for ( std::size_t r = 0; r < rounds; ++r )
+	{
+		Bench::Clock::time_point const start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			checksum += StringHash::checkHash( checked[i].data(), checked[i].size() );
+		}
+
+		best_check = std::min( best_check, Bench::elapsed( start ) / count );
+	}
+#endif
+
+	std::printf( "%zu names, best of %zu, %s\n", count, rounds, HASH_STRING_SEEDED ? "seeded" : HASH_STRING_RESOLVE_COLLISIONS ? "unseeded" : "no collision resolution" );
+	std::printf( "miss         %8.1f ns  %8.4f operator new per name\n", best_miss, double( miss_allocations ) / ( count * rounds ) );
+	std::printf( "hit          %8.1f ns  %8.4f operator new per name\n", best_hit, double( hit_allocations ) / ( count * rounds ) );
+	std::printf( "lookup miss  %8.1f ns\n", best_lookup_miss );
+	std::printf( "find, half hits: tryFind() %8.1f ns, isStringInterned() + HashString( StringID ) %8.1f ns\n",
+		best_try_find, best_two_calls );
+	std::printf( "internString() loop  %8.1f ms\n", best_loop / 1e6 );
+	std::printf( "internStrings()      %8.1f ms\n", best_batch / 1e6 );
+#if HASH_STRING_RESOLVE_COLLISIONS
+	std::printf( "check hash   %8.1f ns\n", best_check );
+#endif
+	std::printf( "checksum %zu\n", checksum );
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+/** \brief std::map against InternTable on the same random ids.
+ *  The intern table started out as a std::map< StringID, std::string >,
+ *  this measures both on insert and on lookups in random order, and the
+ *  table's bytesReserved() per entry.  TableBenchId32 and TableBenchId64
+ *  build it with each HASH_STRING_ID_BITS.
+ *
+ *  Usage: TableBench [count...], defaults to 1000 100000 10000000
+ */
+
+#include "Bench.h"
+#include "InternTable.h"
+
+#include <cstdio>
+#include <map>
+#include <memory>
+
+namespace
+{
+	/// Insert and lookup ns per id of a std::map, the table before InternTable
+	void measureMap( std::vector< StringID > const & ids, std::vector< std::string > const & texts,
+		std::vector< std::size_t > const & order, double & insert_ns, double & lookup_ns, std::size_t & checksum )
+	{
+		std::map< StringID, std::string > map;
+
+		Bench::Clock::time_point start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < ids.size(); ++i )
+		{
+			map.insert( std::make_pair( ids[i], texts[i] ) );
+		}
+
+		insert_ns = Bench::elapsed( start ) / ids.size();
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < order.size(); ++i )
+		{
+			checksum += map.find( ids[ order[i] ] )->second.size();
+		}
+
+		lookup_ns = Bench::elapsed( start ) / order.size();
+	}
+
+	/// Insert and lookup ns per id of an InternTable, and its bytes per entry
+	void measureTable( std::vector< StringID > const & ids, std::vector< std::string > const & texts,
+		std::vector< std::size_t > const & order, double & insert_ns, double & lookup_ns, double & bytes, std::size_t & checksum )
+	{
+		std::unique_ptr< StringIndex > index( new StringIndex( "", 0 ) );
+		std::unique_ptr< InternTable > table( new InternTable() );
+		std::vector< StringID > interned( ids );
+
+		Bench::Clock::time_point start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < ids.size(); ++i )
+		{
+			table->insert( *index, interned[i], texts[i].data(), texts[i].size() );
+		}
+
+		insert_ns = Bench::elapsed( start ) / ids.size();
+		start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < order.size(); ++i )
+		{
+			checksum += table->find( interned[ order[i] ] );
+		}
+
+		lookup_ns = Bench::elapsed( start ) / order.size();
+		bytes = static_cast< double >( table->bytesReserved() ) / ids.size();
+	}
+}
+
+int main( int argc, char ** argv )
+{
+	std::vector< std::size_t > counts;
+
+	for ( int i = 1; i < argc; ++i )
+	{
+		counts.push_back( Bench::argument( argc, argv, i, 0 ) );
+	}
+
+	if ( counts.empty() )
+	{
+		counts.push_back( 1000 );
+		counts.push_back( 100000 );
+		counts.push_back( 10000000 );
+	}
+
+	std::printf( "%d bit ids\n", HASH_STRING_ID_BITS );
+	std::printf( "%10s  %22s  %22s  %12s\n", "entries", "map insert/lookup ns", "table insert/lookup ns", "table bytes" );
+
+	std::size_t checksum = 0;
+
+	for ( std::size_t c = 0; c < counts.size(); ++c )
+	{
+		Bench::Random random( 1 + c );
+		std::vector< StringID > ids( counts[c] );
+		std::vector< std::string > texts( counts[c] );
+		std::vector< std::size_t > order( counts[c] );
+
+		for ( std::size_t i = 0; i < counts[c]; ++i )
+		{
+			ids[i] = static_cast< StringID >( random.next() );
+			texts[i] = std::to_string( ids[i] );
+			order[i] = i;
+		}
+
+		Bench::shuffle( order, random );
+
+		double map_insert, map_lookup, table_insert, table_lookup, table_bytes;
+		measureMap( ids, texts, order, map_insert, map_lookup, checksum );
+		measureTable( ids, texts, order, table_insert, table_lookup, table_bytes, checksum );
+
+		std::printf( "%10zu  %10.1f / %9.1f  %10.1f / %9.1f  %12.1f\n", counts[c], map_insert, map_lookup, table_insert, table_lookup, table_bytes );
+	}
+
+	std::printf( "checksum %zu\n", checksum );
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+/** \brief Lookups from many threads at once.
+ *  read: 99% getStringFromHash() of an interned id, 1% internString() of
+ *  a new name, the read heavy mix the lock free lookups are for
+ *  check: isStringInterned() with half of the names interned
+ *
+ *  Over 200K interned names, with 1, 4, 16 and 64 threads.  Reports wall
+ *  time over all operations, so it stays flat when threads scale
+ *  perfectly on one core.  Needs HASH_STRING_THREAD_SAFE for more than
+ *  one thread.
+ *
+ *  Usage: ThreadBench [read|check] [operations per thread], defaults to read 200000
+ */
+
+#include "Bench.h"
+#include "HashString.h"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	/// Interned names
+	std::size_t const kNames = 200000;
+
+	/// What one thread does
+	struct Worker
+	{
+		bool m_check;
+		std::size_t m_operations;
+		std::size_t m_thread;
+		std::vector< StringID > const * m_ids;
+		std::vector< std::string > const * m_probes;
+		std::size_t m_checksum;
+	};
+
+	void run( Worker * worker )
+	{
+		Bench::Random random( 1 + worker->m_thread );
+		std::size_t checksum = 0;
+
+		for ( std::size_t i = 0; i < worker->m_operations; ++i )
+		{
+			if ( worker->m_check )
+			{
+				checksum += HashString::isStringInterned( ( *worker->m_probes )[ random.below( worker->m_probes->size() ) ] );
+			}
+			else if ( random.below( 100 ) == 0 )
+			{
+				checksum += HashString::internString( "Thread" + std::to_string( worker->m_thread ) + "/New_" + std::to_string( i ) );
+			}
+			else
+			{
+				checksum += HashString::getCStringFromHash( ( *worker->m_ids )[ random.below( worker->m_ids->size() ) ] )[0];
+			}
+		}
+
+		worker->m_checksum = checksum;
+	}
+}
+
+int main( int argc, char ** argv )
+{
+	bool const check = argc > 1 && std::strcmp( argv[1], "check" ) == 0;
+	std::size_t const operations = Bench::argument( argc, argv, 2, 200000 );
+
+	std::vector< std::string > const names = Bench::names( kNames, "Thread" );
+	std::vector< StringID > ids( kNames );
+
+	for ( std::size_t i = 0; i < kNames; ++i )
+	{
+		ids[i] = HashString::internString( names[i] );
+	}
+
+	// Half interned, half not
+	std::vector< std::string > probes( names.begin(), names.begin() + kNames / 2 );
+	std::vector< std::string > const absent = Bench::names( kNames / 2, "Absent" );
+	probes.insert( probes.end(), absent.begin(), absent.end() );
+
+#if HASH_STRING_THREAD_SAFE
+	std::size_t const thread_counts[] = { 1, 4, 16, 64 };
+#else
+	std::size_t const thread_counts[] = { 1 };
+	std::printf( "single threaded build, 1 thread only\n" );
+#endif
+
+	std::printf( "%s, %zu operations per thread\n", check ? "check" : "read", operations );
+
+	for ( std::size_t t = 0; t < sizeof( thread_counts ) / sizeof( thread_counts[0] ); ++t )
+	{
+		std::size_t const thread_count = thread_counts[t];
+		std::vector< Worker > workers( thread_count );
+		std::vector< std::thread > threads;
+
+		for ( std::size_t i = 0; i < thread_count; ++i )
+		{
+			Worker const worker = { check, operations, i, &ids, &probes, 0 };
+			workers[i] = worker;
+		}
+
+		Bench::Clock::time_point const start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < thread_count; ++i )
+		{
+			threads.push_back( std::thread( run, &workers[i] ) );
+		}
+
+		std::size_t checksum = 0;
+
+		for ( std::size_t i = 0; i < thread_count; ++i )
+		{
+			threads[i].join();
+			checksum += workers[i].m_checksum;
+		}
+
+		double const nanoseconds = Bench::elapsed( start );
+
+		std::printf( "%3zu threads  %8.1f ns/op  (checksum %zu)\n", thread_count, nanoseconds / ( thread_count * operations ), checksum );
+	}
+
+	return 0;
+}
@@ -0,0 +1,137 @@
+/** \brief The per thread intern cache under a skewed name distribution.
+ *  Interns the names up front, then each thread constructs HashString(
+ *  std::string ) from names drawn with Zipf's law ( s = 1, the k-th most
+ *  common name is drawn in proportion to 1 / k ), the way a few names
+ *  dominate real lookups.  Reports the cache hit rate, from
+ *  getThreadCacheStats(), and wall time over all operations, with 1, 4
+ *  and 16 threads.
+ *
+ *  Built as ZipfBenchCache0, ZipfBenchCache8 and ZipfBenchCache12, all
+ *  with HASH_STRING_THREAD_SAFE and HASH_STRING_THREAD_CACHE_BITS set to
+ *  0, 8 and 12, so one build compares them.
+ *
+ *  Usage: ZipfBenchCache<bits> [names] [operations per thread], defaults to 100000 500000
+ */
+
+#include "Bench.h"
+#include "HashString.h"
+
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+	/// What one thread does
+	struct Worker
+	{
+		std::vector< std::string > const * m_names;
+		std::vector< std::uint32_t > m_draws;
+		HashString::ThreadCacheStats m_stats;
+		std::size_t m_checksum;
+	};
+
+	void run( Worker * worker )
+	{
+		HashString::ThreadCacheStats const before = HashString::getThreadCacheStats();
+		std::vector< std::string > const & names = *worker->m_names;
+		std::size_t checksum = 0;
+
+		for ( std::size_t i = 0; i < worker->m_draws.size(); ++i )
+		{
+			checksum += HashString( names[ worker->m_draws[i] ] ).getIndex();
+		}
+
+		HashString::ThreadCacheStats const after = HashString::getThreadCacheStats();
+
+		worker->m_stats.m_hits = after.m_hits - before.m_hits;
+		worker->m_stats.m_misses = after.m_misses - before.m_misses;
+		worker->m_checksum = checksum;
+	}
+
+	/// count draws from Zipf's law over cumulative, which sums 1 / k up to each name
+	std::vector< std::uint32_t > draw( std::vector< double > const & cumulative, std::size_t count, Bench::Random & random )
+	{
+		std::vector< std::uint32_t > draws( count );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			// 53 random bits, uniform in [0, total)
+			double const u = static_cast< double >( random.next() >> 11 ) / 9007199254740992.0 * cumulative.back();
+
+			draws[i] = static_cast< std::uint32_t >( std::upper_bound( cumulative.begin(), cumulative.end(), u ) - cumulative.begin() );
+		}
+
+		return draws;
+	}
+}
+
+int main( int argc, char ** argv )
+{
+	std::size_t const name_count = Bench::argument( argc, argv, 1, 100000 );
+	std::size_t const operations = Bench::argument( argc, argv, 2, 500000 );
+
+	std::vector< std::string > names = Bench::names( name_count, "Zipf" );
+	std::vector< double > cumulative( name_count );
+	double total = 0.0;
+
+	for ( std::size_t i = 0; i < name_count; ++i )
+	{
+		HashString::internString( names[i] );
+
+		total += 1.0 / static_cast< double >( i + 1 );
+		cumulative[i] = total;
+	}
+
+	// The common names are not the first ones interned
+	Bench::Random order( 7 );
+	Bench::shuffle( names, order );
+
+#if HASH_STRING_THREAD_SAFE
+	std::size_t const thread_counts[] = { 1, 4, 16 };
+#else
+	std::size_t const thread_counts[] = { 1 };
+	std::printf( "single threaded build, 1 thread only\n" );
+#endif
+
+	std::printf( "cache bits %d, %zu names, %zu operations per thread\n", HASH_STRING_THREAD_CACHE_BITS, name_count, operations );
+
+	for ( std::size_t t = 0; t < sizeof( thread_counts ) / sizeof( thread_counts[0] ); ++t )
+	{
+		std::size_t const thread_count = thread_counts[t];
+		std::vector< Worker > workers( thread_count );
+		std::vector< std::thread > threads;
+
+		for ( std::size_t i = 0; i < thread_count; ++i )
+		{
+			Bench::Random random( 1 + i );
+
+			workers[i].m_names = &names;
+			workers[i].m_draws = draw( cumulative, operations, random );
+		}
+
+		Bench::Clock::time_point const start = Bench::Clock::now();
+
+		for ( std::size_t i = 0; i < thread_count; ++i )
+		{
+			threads.push_back( std::thread( run, &workers[i] ) );
+		}
+
+		std::size_t checksum = 0;
+		std::size_t hits = 0;
+
+		for ( std::size_t i = 0; i < thread_count; ++i )
+		{
+			threads[i].join();
+			checksum += workers[i].m_checksum;
+			hits += workers[i].m_stats.m_hits;
+		}
+
+		double const nanoseconds = Bench::elapsed( start );
+		double const ops = static_cast< double >( thread_count * operations );
+
+		std::printf( "%3zu threads  hit rate %5.1f%%  %8.1f ns/op  (checksum %zu)\n", thread_count,
+			100.0 * static_cast< double >( hits ) / ops, nanoseconds / ops, checksum );
+	}
+
+	return 0;
+}
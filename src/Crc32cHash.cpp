@@ -0,0 +1,101 @@
+#include "HashStringConfig.h"
+
+// Only built into the library when it is the string hash
+#if HASH_STRING_HASH == HASH_STRING_HASH_CRC32C
+
+#include "Crc32cHash.h"
+
+#include <cstring>
+
+#if defined( __GNUC__ ) && defined( __x86_64__ )
+#define HASH_STRING_SSE42_CRC 1
+#include <nmmintrin.h>
+#else
+#define HASH_STRING_SSE42_CRC 0
+#endif
+
+namespace
+{
+	/// CRC of every byte value, one lookup per byte
+	struct CrcTable
+	{
+		CrcTable()
+		{
+			for ( std::uint32_t i = 0; i < 256; ++i )
+			{
+				m_entries[i] = Crc32cHash::shiftConstexpr( i, 8 );
+			}
+		}
+
+		std::uint32_t m_entries[ 256 ];
+	};
+
+	std::uint32_t updateTable( char const * str, std::size_t length, std::uint32_t crc )
+	{
+		static CrcTable const table;
+
+		for ( std::size_t i = 0; i < length; ++i )
+		{
+			crc = ( crc >> 8 ) ^ table.m_entries[ ( crc ^ static_cast< unsigned char >( str[i] ) ) & 0xFF ];
+		}
+
+		return crc;
+	}
+
+#if HASH_STRING_SSE42_CRC
+	/// SSE4.2 crc32 instruction, only called when the CPU has it
+	__attribute__(( target( "sse4.2" ) ))
+	std::uint32_t updateHardware( char const * str, std::size_t length, std::uint32_t crc )
+	{
+		std::uint64_t crc64 = crc;
+		std::size_t i = 0;
+
+		for ( ; i + 8 <= length; i += 8 )
+		{
+			std::uint64_t word;
+			std::memcpy( &word, str + i, sizeof( word ) );
+			crc64 = _mm_crc32_u64( crc64, word );
+		}
+
+		crc = static_cast< std::uint32_t >( crc64 );
+
+		for ( ; i < length; ++i )
+		{
+			crc = _mm_crc32_u8( crc, static_cast< unsigned char >( str[i] ) );
+		}
+
+		return crc;
+	}
+#endif
+
+	typedef std::uint32_t ( * Update )( char const *, std::size_t, std::uint32_t );
+
+	/// Fastest update for the CPU we run on
+	Update pickUpdate()
+	{
+#if HASH_STRING_SSE42_CRC
+		__builtin_cpu_init();
+
+		if ( __builtin_cpu_supports( "sse4.2" ) )
+		{
+			return updateHardware;
+		}
+#endif
+
+		return updateTable;
+	}
+}
+
+StringID Crc32cHash::hash( char const * str, std::size_t length )
+{
+	static Update const update = pickUpdate();
+
+	return ~update( str, length, 0xFFFFFFFFu );
+}
+
+StringID Crc32cHash::hashTable( char const * str, std::size_t length )
+{
+	return ~updateTable( str, length, 0xFFFFFFFFu );
+}
+
+#endif
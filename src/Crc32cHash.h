@@ -0,0 +1,53 @@
+#ifndef CRC32C_HASH_H
+#define CRC32C_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "StringID.h"
+
+#if HASH_STRING_ID_BITS != 32
+#error "CRC32C only makes 32 bit StringIDs"
+#endif
+
+/** \brief CRC32C ( Castagnoli ), as used by iSCSI and ext4.
+ *  Selected with HASH_STRING_HASH.  Run time hashing uses the SSE4.2 crc32
+ *  instruction, 8 bytes at a time, when the CPU has it, and a table
+ *  otherwise.  32 bit StringIDs only.
+ */
+namespace Crc32cHash
+{
+	/// Reflected Castagnoli polynomial
+	std::uint32_t const kPolynomial = 0x82F63B78u;
+
+	/// Shifts bits more bits through the CRC register
+	constexpr std::uint32_t shiftConstexpr( std::uint32_t crc, unsigned bits )
+	{
+		return bits == 0
+			? crc
+			: shiftConstexpr( ( crc >> 1 ) ^ ( kPolynomial & ( 0u - ( crc & 1u ) ) ), bits - 1 );
+	}
+
+	/// CRC register after the characters, before the final inversion
+	constexpr std::uint32_t updateConstexpr( char const * str, std::size_t length, std::uint32_t crc )
+	{
+		return length == 0
+			? crc
+			: updateConstexpr( str + 1, length - 1,
+				shiftConstexpr( crc ^ static_cast< unsigned char >( *str ), 8 ) );
+	}
+
+	/// Compile time CRC32C, recursive so it is a valid C++11 constexpr function
+	constexpr StringID hashConstexpr( char const * str, std::size_t length )
+	{
+		return ~updateConstexpr( str, length, 0xFFFFFFFFu );
+	}
+
+	/// Run time CRC32C, same result as hashConstexpr()
+	StringID hash( char const * str, std::size_t length );
+
+	/// Run time CRC32C from a byte table, what hash() uses on CPUs without SSE4.2
+	StringID hashTable( char const * str, std::size_t length );
+}
+
+#endif
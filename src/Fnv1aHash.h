@@ -0,0 +1,53 @@
+#ifndef FNV1A_HASH_H
+#define FNV1A_HASH_H
+
+#include <cstddef>
+
+#include "StringID.h"
+
+/** \brief FNV-1a over the bytes of a string, 32 or 64 bit to match StringID.
+ *  The default string hash, see HASH_STRING_HASH.  Fast for the short
+ *  names it is usually given, and the only hash StringHash can also
+ *  compute for many strings at once in vector lanes.
+ */
+namespace Fnv1aHash
+{
+#if HASH_STRING_ID_BITS == 64
+	StringID const kOffsetBasis = 14695981039346656037ull;
+	StringID const kPrime = 1099511628211ull;
+#else
+	StringID const kOffsetBasis = 2166136261u;
+	StringID const kPrime = 16777619u;
+#endif
+
+	/** \brief Compile time FNV-1a.
+	  * \param str Characters to hash
+	  * \param length Number of characters
+	  * \param hash Hash of the characters before str
+	  * \return StringID of the characters.
+	  * \note Recursive so it is a valid C++11 constexpr function, use
+	  *     hash() for run time hashing.
+	  */
+	constexpr StringID hashConstexpr( char const * str, std::size_t length, StringID hash = kOffsetBasis )
+	{
+		return length == 0
+			? hash
+			: hashConstexpr( str + 1, length - 1,
+				( hash ^ static_cast< unsigned char >( *str ) ) * kPrime );
+	}
+
+	/// Run time FNV-1a, same result as hashConstexpr()
+	inline StringID hash( char const * str, std::size_t length )
+	{
+		StringID hash_value = kOffsetBasis;
+
+		for ( std::size_t i = 0; i < length; ++i )
+		{
+			hash_value = ( hash_value ^ static_cast< unsigned char >( str[i] ) ) * kPrime;
+		}
+
+		return hash_value;
+	}
+}
+
+#endif
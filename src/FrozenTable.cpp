@@ -0,0 +1,205 @@
+#include "FrozenTable.h"
+#include "StringHash.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	/// Average ids per bucket, more makes pilots take less room but harder to find
+	std::size_t const kBucketSize = 3;
+
+	/// Largest pilot, a bucket that needs more starts the build over with another seed
+	std::uint32_t const kMaxPilot = 0xFFFF;
+
+	/// Position nothing has been placed at yet
+	std::uint32_t const kFree = 0xFFFFFFFFu;
+
+	/// Seed of the first build
+	std::uint64_t initialSeed()
+	{
+#if HASH_STRING_SEEDED
+		// Which ids share a bucket is unknown without the key, so no one can make a build fail
+		return SipHash::hash( StringHash::key(), "frozen", 6 );
+#else
+		return 0x5851F42D4C957F2Dull;
+#endif
+	}
+}
+
+FrozenTable::FrozenTable( StringID const * keys, std::uint32_t const * values, std::size_t count )
+:	m_size( count ),
+	m_positions( static_cast< std::uint32_t >( count + count / 32 + 1 ) ),
+	m_bucketCount( static_cast< std::uint32_t >( count / kBucketSize + 1 ) ),
+	m_seed( initialSeed() ),
+	m_pilots( static_cast< std::uint16_t * >( ZeroedMemory::allocate( ( count / kBucketSize + 1 ) * sizeof( std::uint16_t ) ) ) ),
+	m_remap( static_cast< std::uint32_t * >( ZeroedMemory::allocate( ( count / 32 + 1 ) * sizeof( std::uint32_t ) ) ) ),
+	m_slots( static_cast< Slot * >( ZeroedMemory::allocate( ( count != 0 ? count : 1 ) * sizeof( Slot ) ) ) )
+{
+	while ( !build( keys, values ) )
+	{
+		m_seed = m_seed * 6364136223846793005ull + 1442695040888963407ull;
+	}
+}
+
+bool FrozenTable::build( StringID const * keys, std::uint32_t const * values )
+{
+	// Group the ids by bucket, with a counting sort
+	std::vector< std::uint64_t > hashes( m_size );
+	std::vector< std::uint32_t > starts( m_bucketCount + 1 );
+
+	for ( std::size_t i = 0; i < m_size; ++i )
+	{
+		hashes[i] = hash( keys[i] );
+		++starts[ bucket( hashes[i] ) + 1 ];
+	}
+
+	for ( std::uint32_t b = 0; b < m_bucketCount; ++b )
+	{
+		starts[ b + 1 ] += starts[b];
+	}
+
+	// Each bucket's ids and hashes side by side, so trying a pilot reads one short run
+	std::vector< std::uint32_t > members( m_size );
+	std::vector< std::uint64_t > member_hashes( m_size );
+	std::vector< std::uint32_t > next( starts.begin(), starts.end() - 1 );
+
+	for ( std::size_t i = 0; i < m_size; ++i )
+	{
+		std::uint32_t const at = next[ bucket( hashes[i] ) ]++;
+
+		members[at] = static_cast< std::uint32_t >( i );
+		member_hashes[at] = hashes[i];
+	}
+
+	// Largest buckets first, while most positions are still free, another counting sort
+	std::uint32_t largest = 0;
+
+	for ( std::uint32_t b = 0; b < m_bucketCount; ++b )
+	{
+		largest = std::max( largest, starts[ b + 1 ] - starts[b] );
+	}
+
+	std::vector< std::uint32_t > size_starts( largest + 2 );
+
+	for ( std::uint32_t b = 0; b < m_bucketCount; ++b )
+	{
+		++size_starts[ largest - ( starts[ b + 1 ] - starts[b] ) + 1 ];
+	}
+
+	for ( std::uint32_t size = 0; size <= largest; ++size )
+	{
+		size_starts[ size + 1 ] += size_starts[size];
+	}
+
+	std::vector< std::uint32_t > order( m_bucketCount );
+
+	for ( std::uint32_t b = 0; b < m_bucketCount; ++b )
+	{
+		order[ size_starts[ largest - ( starts[ b + 1 ] - starts[b] ) ]++ ] = b;
+	}
+
+	// Id placed at each position, and a bit per position that is small enough to stay in cache while pilots are tried
+	std::vector< std::uint32_t > owner( m_positions, kFree );
+	std::vector< std::uint64_t > taken( m_positions / 64 + 1 );
+	std::vector< std::uint32_t > placed;
+
+	for ( std::uint32_t i = 0; i < m_bucketCount; ++i )
+	{
+		std::uint32_t const b = order[i];
+		std::uint32_t const first = starts[b];
+		std::uint32_t const size = starts[ b + 1 ] - first;
+
+		if ( size == 0 )
+		{
+			break;
+		}
+
+		placed.resize( size );
+
+		std::uint32_t pilot = 0;
+
+		for ( ; pilot <= kMaxPilot; ++pilot )
+		{
+			std::uint32_t j = 0;
+
+			for ( ; j < size; ++j )
+			{
+				std::uint32_t const pos = position( member_hashes[ first + j ], static_cast< std::uint16_t >( pilot ) );
+
+				if ( ( taken[ pos / 64 ] >> ( pos % 64 ) & 1 ) != 0 || std::find( placed.begin(), placed.begin() + j, pos ) != placed.begin() + j )
+				{
+					break;
+				}
+
+				placed[j] = pos;
+			}
+
+			if ( j == size )
+			{
+				break;
+			}
+		}
+
+		if ( pilot > kMaxPilot )
+		{
+			return false;
+		}
+
+		m_pilots[b] = static_cast< std::uint16_t >( pilot );
+
+		for ( std::uint32_t j = 0; j < size; ++j )
+		{
+			owner[ placed[j] ] = members[ first + j ];
+			taken[ placed[j] / 64 ] |= std::uint64_t( 1 ) << ( placed[j] % 64 );
+		}
+	}
+
+	// Every position past the slots leaves a free slot below them to remap it to
+	std::uint32_t free_slot = 0;
+
+	for ( std::uint32_t pos = 0; pos < m_positions; ++pos )
+	{
+		std::uint32_t const member = owner[pos];
+
+		if ( member == kFree )
+		{
+			continue;
+		}
+
+		std::uint32_t slot = pos;
+
+		if ( pos >= m_size )
+		{
+			while ( owner[ free_slot ] != kFree )
+			{
+				++free_slot;
+			}
+
+			owner[ free_slot ] = member;
+			m_remap[ pos - m_size ] = free_slot;
+			slot = free_slot;
+		}
+
+		m_slots[ slot ].m_key = keys[member];
+		m_slots[ slot ].m_value = values[member];
+	}
+
+	return true;
+}
+
+void FrozenTable::prefetch( StringID id ) const
+{
+#if defined( __GNUC__ )
+	__builtin_prefetch( &m_pilots[ bucket( hash( id ) ) ] );
+#else
+	( void )id;
+#endif
+}
+
+std::size_t FrozenTable::bytesReserved() const
+{
+	return m_bucketCount * sizeof( std::uint16_t )
+		+ ( m_positions - m_size ) * sizeof( std::uint32_t )
+		+ ( m_size != 0 ? m_size : 1 ) * sizeof( Slot );
+}
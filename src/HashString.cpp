@@ -1,131 +1,326 @@
 #include "HashString.h"
-#include <iostream>
+#include <ostream>
 #include <cassert>
+#include <cstring>
+#include <vector>
 
 using namespace std;
 
-HashString::InternStringMap * HashString::s_internedStrings;
-std::hash<std::string> * HashString::s_stringHash;
+namespace
+{
+	/** \brief Holds the interned string table, and never destroys it.
+	 *  Constant initialized, so HashStrings work from any static initializer
+	 *  in any order, and never destroyed, so they keep working from static
+	 *  destructors too.  The table allocates only as strings are interned.
+	 */
+	union GlobalTable
+	{
+		constexpr GlobalTable() : m_table() {}
+		~GlobalTable() {}
 
-/// Static Counter
-static int s_schwarzCounter = 0;
+		ShardedInternTable m_table;
+	};
 
-int HashStringInitilizer::getSchwarz()
-{
-    return s_schwarzCounter;
-}
+	GlobalTable s_globalTable;
 
-/// Static Initializer of HashString table and hash function
-HashStringInitilizer::HashStringInitilizer()
-{
-    if ( s_schwarzCounter == 0 )
-    {
-        HashString::s_internedStrings = new HashString::InternStringMap();
-        HashString::s_stringHash = new std::hash<std::string>();
+	/// Interned String table
+	ShardedInternTable & s_internedStrings = s_globalTable.m_table;
+}
 
-        //cout << "inited\n";
+HashString const HashString::s_kEmptyString( ShardedInternTable::kEmptyIndex, ShardedInternTable::kEmptyId );
 
-        s_schwarzCounter++;
-    }
+#if HASH_STRING_THREAD_CACHE_BITS
+namespace
+{
+	/** \brief Strings this thread interned recently, direct mapped on requested StringID.
+	 *  Entries hold StringIndex indices, which never change once handed
+	 *  out, so growing the table never invalidates them.
+	 */
+	struct ThreadInternCache
+	{
+		/// m_entry is the index + 1, 0 when empty
+		struct Entry
+		{
+			std::uint32_t m_entry;
+			std::uint32_t m_length;
+			StringID m_requestedId;
+			StringID m_id;
+		};
+
+		static std::size_t const kEntries = std::size_t( 1 ) << HASH_STRING_THREAD_CACHE_BITS;
+
+		Entry m_entries[ kEntries ];
+		HashString::ThreadCacheStats m_stats;
+	};
+
+	/// Zero initialized, so there is no per thread construction cost
+	thread_local ThreadInternCache t_internCache;
 }
+#endif
 
-/// Static Deconstructor of HashString table and hash function
-HashStringInitilizer::~HashStringInitilizer()
+HashString::Index HashString::intern( StringID & id, char const * str, std::size_t length )
 {
-    if ( --s_schwarzCounter == 0 )
+#if HASH_STRING_THREAD_CACHE_BITS
+	// Fibonacci hashing, the low bits of an id also pick its shard
+	ThreadInternCache::Entry & entry = t_internCache.m_entries[
+		( static_cast< std::uint32_t >( id ) * 0x9E3779B9u ) >> ( 32 - HASH_STRING_THREAD_CACHE_BITS ) ];
+
+	if ( entry.m_entry != 0 && entry.m_requestedId == id && entry.m_length == length
+#if HASH_STRING_RESOLVE_COLLISIONS
+		&& StringArena::check( s_internedStrings.string( entry.m_entry - 1 ) ) == StringHash::checkHash( str, length )
+#endif
+		)
 	{
-		delete HashString::s_internedStrings;
-		delete HashString::s_stringHash;
+		++t_internCache.m_stats.m_hits;
+		id = entry.m_id;
+
+		return entry.m_entry - 1;
 	}
+
+	++t_internCache.m_stats.m_misses;
+
+	// insert() may throw, and updates id, so the entry is only written once it returns
+	StringID const requested_id = id;
+	Index const index = s_internedStrings.insert( id, str, length );
+
+	entry.m_entry = index + 1;
+	entry.m_length = static_cast< std::uint32_t >( length );
+	entry.m_requestedId = requested_id;
+	entry.m_id = id;
+
+	return index;
+#else
+	return s_internedStrings.insert( id, str, length );
+#endif
 }
 
-HashString const HashString::s_kEmptyString("");
+HashString::ThreadCacheStats HashString::getThreadCacheStats()
+{
+#if HASH_STRING_THREAD_CACHE_BITS
+	return t_internCache.m_stats;
+#else
+	ThreadCacheStats stats = { 0, 0 };
+
+	return stats;
+#endif
+}
 
 /// Returns true if string is already interned
 bool HashString::isStringInterned( std::string const & str )
 {
-	// Hash it's value, find if that is key in map
-	StringID hash_value = (*s_stringHash)( str );
+	return isStringInterned( str.data(), str.size() );
+}
 
-	if ( s_internedStrings->find( hash_value ) != s_internedStrings->cend() )
-	{
-		return true;
-	}
+bool HashString::isStringInterned( char const * str, std::size_t length )
+{
+	// Hash it's value, find if that is key in map
+	StringID hash_value = StringHash::hash( str, length );
 
-	return false;
+	return s_internedStrings.find( hash_value, str, length ) != StringIndex::kNoIndex;
 }
 
 bool HashString::isStringInterned( StringID const & hash_value )
 {
-	// Hash it's value, find if that is key in map
-	if ( s_internedStrings->find( hash_value ) != s_internedStrings->cend() )
+	return s_internedStrings.find( hash_value ) != StringIndex::kNoIndex;
+}
+
+std::size_t HashString::areStringsInterned( char const * const * strs, std::size_t const * lengths, std::size_t count, bool * interned )
+{
+	std::vector< StringID > ids( count );
+	StringHash::hash( strs, lengths, count, ids.data() );
+
+	std::size_t found = 0;
+
+	for ( std::size_t i = 0; i < count; ++i )
 	{
-		return true;
+		interned[i] = s_internedStrings.find( ids[i], strs[i], lengths[i] ) != StringIndex::kNoIndex;
+		found += interned[i];
 	}
 
-	return false;
+	return found;
 }
 
 /// Interns the string for future use
 StringID HashString::internString( std::string const & str )
 {
-	StringID hash_value = (*s_stringHash)( str );
+	return internString( str.data(), str.size() );
+}
+
+StringID HashString::internString( char const * str, std::size_t length )
+{
+	StringID hash_value = StringHash::hash( str, length );
+
+	// Intern returns the existing entry if it is already interned,
+	// and moves hash_value if the string collided
+	intern( hash_value, str, length );
+
+	return hash_value;
+}
+
+void HashString::internStrings( char const * const * strs, std::size_t const * lengths, std::size_t count, StringID * ids )
+{
+	StringHash::hash( strs, lengths, count, ids );
+
+	s_internedStrings.insert( ids, strs, lengths, count );
+}
+
+void HashString::internStrings( std::string const * strs, std::size_t count, StringID * ids )
+{
+	std::vector< char const * > ptrs( count );
+	std::vector< std::size_t > lengths( count );
 
-	/// If we are able to find it, return the hash_value
-	if ( s_internedStrings->find( hash_value ) != s_internedStrings->cend() )
+	for ( std::size_t i = 0; i < count; ++i )
 	{
-		return hash_value;
+		ptrs[i] = strs[i].data();
+		lengths[i] = strs[i].size();
 	}
 
-	// Add string to interned table
-	s_internedStrings->insert( InternStringPair( hash_value, str ) );
+	internStrings( ptrs.data(), lengths.data(), count, ids );
+}
 
-	return hash_value;
+bool HashString::tryFind( char const * str, std::size_t length, HashString & found )
+{
+	StringID hash_value = StringHash::hash( str, length );
+	Index const index = s_internedStrings.find( hash_value, str, length );
+
+	if ( index == StringIndex::kNoIndex )
+	{
+		return false;
+	}
+
+	found.m_index = index;
+	found.m_hashValue = hash_value;
+
+	return true;
+}
+
+bool HashString::tryFind( std::string const & str, HashString & found )
+{
+	return tryFind( str.data(), str.size(), found );
+}
+
+std::size_t HashString::getInternedCount()
+{
+	return s_internedStrings.size();
+}
+
+std::size_t HashString::getCollisionCount()
+{
+	return s_internedStrings.collisions();
+}
+
+void HashString::reserve( std::size_t count )
+{
+	s_internedStrings.reserve( count );
+}
+
+HashString::GrowthStats HashString::getGrowthStats()
+{
+	return s_internedStrings.growthStats();
+}
+
+void HashString::freeze()
+{
+	s_internedStrings.freeze();
+}
+
+void HashString::reclaim()
+{
+	s_internedStrings.reclaim();
 }
 
 std::string HashString::getStringFromHash( StringID const & id )
 {
 	std::string rval;
 
-	auto iter = s_internedStrings->find( id );
+	char const * str = getCStringFromHash( id );
 
-	if ( iter != s_internedStrings->cend() )
+	if ( str != nullptr )
 	{
-		rval = (*iter).second;
+		rval.assign( str, InternTable::length( str ) );
 	}
 
 	return rval;
 }
 
+char const * HashString::getCStringFromHash( StringID const & id )
+{
+	Index const index = s_internedStrings.find( id );
+
+	if ( index == StringIndex::kNoIndex )
+	{
+		return nullptr;
+	}
+
+	return s_internedStrings.string( index );
+}
+
+HashString HashString::getInterned( Index index )
+{
+	HashString rval;
+
+	s_internedStrings.entry( index, rval.m_hashValue );
+	rval.m_index = index;
+
+	return rval;
+}
+
+namespace
+{
+	/// Copies interned strings into a map
+	struct InternMapCopier
+	{
+		HashString::InternStringMap & m_map;
+
+		void operator()( HashString const & str ) const
+		{
+			m_map.insert( HashString::InternStringMap::value_type(
+				str.getHashValue(), std::string( str.getCString(), str.getLength() ) ) );
+		}
+	};
+}
+
+HashString::InternStringMap HashString::getInternMap()
+{
+	InternStringMap rval;
+	InternMapCopier copier = { rval };
+
+	forEachInterned( copier );
+
+	return rval;
+}
+
 // # End of Static Region
 
 /// Returns string value
 std::string HashString::getString() const
 {
-	return m_mapPosition->second;
+	char const * str = getCString();
+
+	return std::string( str, InternTable::length( str ) );
 }
 
-HashString::HashString()
-:	HashString( s_kEmptyString )	// redirect to copy constructor
+char const * HashString::getCString() const
 {
+	return s_internedStrings.string( m_index );
 }
 
-HashString::HashString( HashString const & other )
-:	m_mapPosition( other.m_mapPosition ),
-	m_hashValue( other.m_hashValue )
+std::size_t HashString::getLength() const
 {
+	return InternTable::length( getCString() );
 }
 
 /// Constructor that creates and ( if it doesn't exist ) adds to the interned string map
 HashString::HashString( std::string const & str )
+:	HashString( str.data(), str.size() )
 {
-	m_hashValue = (*s_stringHash)( str );
-
-    // Insert doesn't care if it already exists
-    std::pair< InternStringMapIter, bool > result =
-		s_internedStrings->insert( InternStringPair( m_hashValue, str ) );
+}
 
-    m_mapPosition = result.first;
+HashString::HashString( char const * str, std::size_t length )
+:	m_hashValue( StringHash::hash( str, length ) )
+{
+    // Intern doesn't care if it already exists
+    m_index = intern( m_hashValue, str, length );
 }
 
 /// Constructor that takes in the string Id, and finds it's string value
@@ -134,76 +329,62 @@ HashString::HashString( std::string const & str )
 HashString::HashString( StringID const & str_id )
 :	m_hashValue( str_id )
 {
-    // Find this key in the map
-    m_mapPosition = s_internedStrings->find( str_id );
+    // Find this key in the table
+    m_index = s_internedStrings.find( str_id );
 
     // it it doesn't exist, complain, loudly
-    if ( m_mapPosition == s_internedStrings->cend() )
+    if ( m_index == StringIndex::kNoIndex )
     {
 		assert ( 0 && "Uninterned HashString Referenced" );
     }
 }
 
 HashString::HashString( char const * c_str )
-:	HashString( std::string( c_str ) )
-{
-}
-
-HashString::~HashString()
-{
-}
-
-// # Operators
-
-HashString & HashString::operator=( HashString const & other )
+:	HashString( c_str, std::strlen( c_str ) )
 {
-	this->m_mapPosition = other.m_mapPosition;
-	m_hashValue = other.m_hashValue;
-
-	return *this;
 }
 
-bool HashString::operator< ( HashString const & other ) const
+HashString::HashString( HashStringLiteral const & literal )
+:	m_hashValue( literal.getHashValue() )
 {
-	return ( m_hashValue < other.m_hashValue );
-}
+	m_index = s_internedStrings.insert( m_hashValue, literal.getString(), literal.getLength() );
 
-bool HashString::operator== ( HashString const & other ) const
-{
-	return ( m_hashValue == other.m_hashValue );
+	// The literal's compile time id now belongs to a different string
+	assert( m_hashValue == literal.getHashValue() && "HashStringLiteral collided" );
 }
 
-bool HashString::operator!= ( HashString const & other ) const
-{
-	return !( m_hashValue == other.m_hashValue );
-}
+// # Operators
 
 bool HashString::operator== ( std::string const & other ) const
 {
-	return ( getString() == other );
+	char const * str = getCString();
+
+	// Compare in place, no copy of the interned text
+	return InternTable::length( str ) == other.size()
+		&& std::memcmp( str, other.data(), other.size() ) == 0;
 }
 
 bool HashString::operator!= ( std::string const & other ) const
 {
-	return ! ( getString() == other );
+	return ! ( *this == other );
 }
 
-bool HashString::operator== ( StringID const & other ) const
+bool HashString::operator== ( HashStringLiteral const & other ) const
 {
-	return ( m_hashValue == other );
+	return ( m_hashValue == other.getHashValue() );
 }
 
-bool HashString::operator!= ( StringID const & other ) const
+bool HashString::operator!= ( HashStringLiteral const & other ) const
 {
-	return ( m_hashValue != other );
+	return ( m_hashValue != other.getHashValue() );
 }
 
-bool HashString::operator< ( StringID const & other ) const
+std::ostream & operator<<( std::ostream & stream, HashString const & str )
 {
-	return ( m_hashValue < other );
+	return stream.write( str.getCString(), str.getLength() );
 }
 
 //HashString::operator StringID const & () const
 //{
-//    return m_mapPosition->first;
+//    return m_hashValue;
 //}
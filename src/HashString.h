@@ -2,11 +2,12 @@
 #define HASH_STRING_H
 
 #include <string>
-#include <functional>
 #include <map>
+#include <iosfwd>
+#include <type_traits>
 
-/// Unique String Identifier
-typedef unsigned int StringID;
+#include "ShardedInternTable.h"
+#include "StringHash.h"
 
 /** \brief String for quick comparisons and copying.
  *  HashString uses a hash function to associate a semi-unique unsigned int id
@@ -52,27 +53,49 @@ typedef unsigned int StringID;
  *	Comparing to previously made HashStrings or directly to the StringID is quick, clean and efficent.
  *	I tell you what.
  *	Create Const HashString early on in code and reference those directly.
+ *
+ *	Best:
+ *	\code
+ *	switch ( event.getEventType().getHashValue() )
+ *	{
+ *		case "PlayerMove"_hs:	// Hashed at compile time
+ *			...
+ *		case "PlayerDie"_hs:
+ *			...
+ *	}
+ *	\endcode
+ *	String literals hashed with _hs or HASH_STRING() cost nothing at run time.
+ *	Their text is interned when a HashString is constructed from them.
  */
 class HashString
 {
-friend class HashStringInitilizer;
 // # Static Region
 
-private:
-    /// Interned String Map Type
+public:
+    /// Dense index of an interned string, see getIndex()
+    typedef StringIndex::Index Index;
+
+    /// Interned String Map Type, as returned by getInternMap()
     typedef std::map< StringID, std::string const > InternStringMap;
-    /// Interned String Insertion Type
-    typedef std::pair< StringID, std::string const > InternStringPair;
-    /// Iterator for Interned String Map
-    typedef InternStringMap::iterator InternStringMapIter;
-    /// Const Iterator for Interned String Map
-    typedef InternStringMap::const_iterator InternStringMapConstIter;
 
-	/// Interned String map
-    static InternStringMap * s_internedStrings;
+    /// Per thread intern cache counters, see HASH_STRING_THREAD_CACHE_BITS
+    struct ThreadCacheStats
+    {
+        std::size_t m_hits;
+        std::size_t m_misses;
+    };
+
+    /// Intern table growth counters, see getGrowthStats()
+    typedef InternTable::GrowthStats GrowthStats;
 
-    /// The hash function
-    static std::hash<std::string> * s_stringHash;
+private:
+    /** \brief Interns through the thread's intern cache, if there is one.
+      * \param id Requested StringID, updated to the id the string is interned under
+      * \param str Characters to intern
+      * \param length Number of characters
+      * \return Index of the interned string.
+      */
+    static Index intern( StringID & id, char const * str, std::size_t length );
 
 public:
 
@@ -82,51 +105,211 @@ public:
       */
 	static bool isStringInterned( std::string const & str );
 
+	/** \brief Returns true if string is already interned, without allocating.
+      * \param str Characters to check for, need not be null terminated
+      * \param length Number of characters
+      * \return True if string is already interned.
+      */
+	static bool isStringInterned( char const * str, std::size_t length );
+
 	/** \brief Returns true if string is already interned.
       * \param hash_value StringID to check for
       * \return True if string is already interned.
       */
 	static bool isStringInterned( StringID const & hash_value );
 
+	/** \brief Checks many strings at once, hashing them together with StringHash::hash().
+	  * \param strs Characters of each string, need not be null terminated
+	  * \param lengths Number of characters of each string
+	  * \param count Number of strings
+	  * \param interned Receives whether each string is interned, count elements
+	  * \return Number of the strings that are interned.
+	  */
+	static std::size_t areStringsInterned( char const * const * strs, std::size_t const * lengths, std::size_t count, bool * interned );
+
 	/** \brief Interns the string for future use.
 	  * \param str String to intern
 	  * \return String ID this string is linked to.
 	  * \note Interning an already intern string will have no
 	  *     negative effect. It will simply return the existing
 	  *     ID, but not add it.
+	  * \note str is never kept: a new string's characters are copied
+	  *     into the intern table's arena, which allocates in large pages,
+	  *     so there is no allocation per string ( see tests/AllocationTest )
+	  *     and nothing to gain from moving a temporary in.
 	  */
     static StringID internString( std::string const & str );
 
+	/** \brief Interns the characters for future use.
+	  * Only copies the characters if they are not interned yet.
+	  * \param str Characters to intern, need not be null terminated
+	  * \param length Number of characters
+	  * \return String ID this string is linked to.
+	  */
+    static StringID internString( char const * str, std::size_t length );
+
+	/** \brief Interns many strings at once, faster than one internString() each.
+	  * Hashes every string up front with StringHash::hash(), several at a
+	  * time in vector lanes, then visits each intern table shard
+	  * once, sizing it for its new strings and taking its lock once.
+	  * \param strs Characters of each string, need not be null terminated
+	  * \param lengths Number of characters of each string
+	  * \param count Number of strings
+	  * \param ids Receives the StringID of each string, count elements
+	  */
+	static void internStrings( char const * const * strs, std::size_t const * lengths, std::size_t count, StringID * ids );
+
+	/// internStrings() over an array of std::string
+	static void internStrings( std::string const * strs, std::size_t count, StringID * ids );
+
+	/** \brief Looks up an already interned string, never interns it.
+	  * Hashes and probes once, so it is cheaper than isStringInterned()
+	  * followed by construction, and safe to call with untrusted input.
+	  * \param str Characters to look for, need not be null terminated
+	  * \param length Number of characters
+	  * \param found Set to the interned string when found, untouched otherwise
+	  * \return True if the string is interned.
+	  */
+	static bool tryFind( char const * str, std::size_t length, HashString & found );
+
+	/// tryFind() for a std::string
+	static bool tryFind( std::string const & str, HashString & found );
+
 	static std::string getStringFromHash( StringID const & id );
+
+	/** \brief Returns the interned text for this id, without copying it.
+	  * \param id StringID to look up
+	  * \return Null terminated interned string, valid for the rest of the
+	  *     program, or nullptr if the id is not interned.
+	  */
+	static char const * getCStringFromHash( StringID const & id );
+
+	/** \brief Number of interned strings, every getIndex() is below it.
+	  * Strings are never removed and keep their index, so the count is also
+	  * an O(1) snapshot of the table: getInterned() of every index below it
+	  * stays valid and returns the same string, whatever is interned later.
+	  */
+	static std::size_t getInternedCount();
+
+	/** \brief Returns the string interned at this index.
+	  * \param index Index below a getInternedCount() taken earlier
+	  */
+	static HashString getInterned( Index index );
+
+	/** \brief Calls visitor( HashString const & ) for every interned string, without copying any text.
+	  * Visits the snapshot given by getInternedCount() on entry, in
+	  * interning order: every string interned before the call, each once,
+	  * and nothing interned after, by other threads or the visitor itself.
+	  * No lock is held, so the visitor may intern strings.
+	  */
+	template < typename Visitor >
+	static void forEachInterned( Visitor visitor );
+
+	/** \brief Number of strings that collided with an already interned StringID.
+	  * \return Collisions resolved so far, always 0 unless built with
+	  *     HASH_STRING_RESOLVE_COLLISIONS.
+	  */
+	static std::size_t getCollisionCount();
 	
-	static std::map< StringID, std::string const > getInternMap() { return *s_internedStrings; }
+	/// Returns the calling thread's intern cache counters, zero if the cache is disabled
+	static ThreadCacheStats getThreadCacheStats();
+
+	/** \brief Sizes the intern table for count strings in total.
+	  * Interning up to count strings then never grows the table, so there
+	  * is no rehash pause while they are interned.  Also see
+	  * HASH_STRING_INITIAL_CAPACITY, which does this on first use.
+	  * \param count Number of strings, say getInternedCount() at the end of the last run
+	  * \throw std::length_error if count is over StringIndex::kMaxSize, the most strings its 32 bit
+	  *     indices can number, nothing is grown then.
+	  * \throw std::bad_alloc if the table for count strings does not fit in memory, part of it may be grown then.
+	  */
+	static void reserve( std::size_t count );
+
+	/** \brief Returns how often the intern table grew and how long it took.
+	  * A growth event gives one shard a slot array twice the size, which
+	  * the following inserts fill from the old one a few slots at a time,
+	  * so it never stalls an insert for long.  After a well sized
+	  * reserve() the count stops rising.
+	  */
+	static GrowthStats getGrowthStats();
+
+	/** \brief Moves the intern table to a minimal perfect hash, for a vocabulary that is complete.
+	  * Builds a minimal perfect hash of every string interned so far, so
+	  * looking one of them up, by StringID or by text, is a single probe.
+	  * Strings can still be interned afterwards, they go to a small
+	  * overflow table that is checked next, and calling freeze() again
+	  * folds them in.  Call it once startup interning is done, it takes a
+	  * few hundred nanoseconds per string and is safe from any thread.
+	  *
+	  * A single probe is not always faster: it loads a pilot and then the
+	  * slot it picks, two cache misses once the table outgrows the cache,
+	  * where the mutable table mostly takes one.  So from about 1M strings
+	  * lookups by StringID, and by text, are slower frozen than before
+	  * ( see bench/FreezeBench ).  Lookups of ids that were never interned
+	  * stay several times faster.
+	  *
+	  * It does not compact the strings, their characters stay where they
+	  * are.  The frozen table, about 9 bytes per string, takes less than
+	  * the slot arrays it replaces, but those are only freed right away in
+	  * single threaded builds, with HASH_STRING_THREAD_SAFE by reclaim().
+	  */
+	static void freeze();
+
+	/** \brief Frees the slot arrays and frozen tables the intern table has replaced.
+	  * With HASH_STRING_THREAD_SAFE the table keeps them after growing or
+	  * freeze(), since a lookup on another thread may still be reading
+	  * them.  Only call it when no other thread can be interning or looking
+	  * up a string, say right after freeze() at the end of startup.  Single
+	  * threaded builds free them right away, and this does nothing.
+	  */
+	static void reclaim();
+
+	/// Returns a copy of every interned string, keyed on StringID, see forEachInterned() to avoid the copy
+	static InternStringMap getInternMap();
 
-	// Const
+	/// The empty string, constant initialized so it is usable from any static initializer
 	static HashString const s_kEmptyString;
 
 // # End of Static Region
 
 private:
 
-    /// Iterator to the position of this entry in the map
-    InternStringMapConstIter m_mapPosition;
+    /// Index of the interned string in the table's StringIndex
+    Index m_index;
 
     StringID m_hashValue;
 
+	/// An already interned string
+	constexpr HashString( Index index, StringID hash_value ) : m_index( index ), m_hashValue( hash_value ) {}
+
 public:
 
 	/// Returns string value
 	std::string getString() const;
 
+	/// Returns the interned text, null terminated and valid for the rest of the program
+	char const * getCString() const;
+
+	/// Returns the length of the interned text
+	std::size_t getLength() const;
+
 	/// Returns string hash value
 	StringID getHashValue() const;
 
-	HashString();
+	/** \brief Returns the dense index of the string.
+	 *  Indices are handed out from 0 in interning order and never change,
+	 *  so they can address side arrays of getInternedCount() elements
+	 *  without any hashing.
+	 */
+	Index getIndex() const;
 
-	HashString( HashString const & other );
+	/// The empty string, constant initialized
+	constexpr HashString() : m_index( ShardedInternTable::kEmptyIndex ), m_hashValue( ShardedInternTable::kEmptyId ) {}
+
+	HashString( HashString const & other ) = default;
 
     /** \brief Constructor that creates and ( if it doesn't exist ) adds to the interned string map
-     *  Constructor that creates and ( if it doesn't exist ) adds to the interned string map.
+     *  Interns str the way internString( std::string const & ) does.
      * \param str String Value
      */
     explicit HashString( std::string const & str );
@@ -139,12 +322,27 @@ public:
      */
     explicit HashString( StringID const & str_id );
 
+	/// Constructor from a null terminated string, doesn't allocate unless the string is new
 	HashString( char const * c_str );
 
-    virtual ~HashString();
+    /** \brief Constructor from a slice of a larger buffer.
+     *  Hashes and looks up the characters in place, they are only copied
+     *  if they are not interned yet.
+     *  \param str Characters, need not be null terminated
+     *  \param length Number of characters
+     */
+	HashString( char const * str, std::size_t length );
+
+    /** \brief Constructor for a compile time hashed literal
+     *  Interns the literal under its precomputed StringID, without hashing it.
+     *  \param literal Literal made with _hs or HASH_STRING()
+     */
+	HashString( HashStringLiteral const & literal );
+
+    ~HashString() = default;
 
 	// # Operators
-	HashString & operator=( HashString const & other );
+	HashString & operator=( HashString const & other ) = default;
 
 	/// Less than operator ( uses m_hashValue )
 	bool operator< ( HashString const & other ) const;
@@ -157,23 +355,70 @@ public:
 	bool operator== ( StringID const & other ) const;
 	bool operator!= ( StringID const & other ) const;
 	bool operator<  ( StringID const & other ) const;
+	bool operator== ( HashStringLiteral const & other ) const;
+	bool operator!= ( HashStringLiteral const & other ) const;
 
 };
 
+// HashStrings are plain handles, containers may copy them with memcpy
+static_assert( std::is_trivially_copyable< HashString >::value, "HashString must be trivially copyable" );
+static_assert( std::is_standard_layout< HashString >::value, "HashString must be standard layout" );
+
+template < typename Visitor >
+void HashString::forEachInterned( Visitor visitor )
+{
+	std::size_t const count = getInternedCount();
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		visitor( getInterned( static_cast< Index >( i ) ) );
+	}
+}
+
 /// Returns string hash value
 inline StringID HashString::getHashValue() const
 {
 	return m_hashValue;
 }
 
-/// This class is used for the static member initilization
-static class HashStringInitilizer
+inline HashString::Index HashString::getIndex() const
 {
-public:
-    HashStringInitilizer();
-    ~HashStringInitilizer();
+	return m_index;
+}
+
+// Id comparisons are inline so sorting and scanning HashStrings doesn't call out
+
+inline bool HashString::operator< ( HashString const & other ) const
+{
+	return ( m_hashValue < other.m_hashValue );
+}
+
+inline bool HashString::operator== ( HashString const & other ) const
+{
+	return ( m_hashValue == other.m_hashValue );
+}
+
+inline bool HashString::operator!= ( HashString const & other ) const
+{
+	return !( m_hashValue == other.m_hashValue );
+}
+
+inline bool HashString::operator== ( StringID const & other ) const
+{
+	return ( m_hashValue == other );
+}
+
+inline bool HashString::operator!= ( StringID const & other ) const
+{
+	return ( m_hashValue != other );
+}
+
+inline bool HashString::operator< ( StringID const & other ) const
+{
+	return ( m_hashValue < other );
+}
 
-    static int getSchwarz();
-} initializer;
+/// Writes the interned text, without copying it into a std::string
+std::ostream & operator<<( std::ostream & stream, HashString const & str );
 
 #endif
@@ -0,0 +1,133 @@
+#ifndef HASH_STRING_CONFIG_H
+#define HASH_STRING_CONFIG_H
+
+/** \file
+ *  Build options for HashString.  Each can be set by the build ( see the
+ *  matching CMake option ), and must be the same for the library and
+ *  everything that includes its headers.
+ */
+
+/** \brief Width of StringID in bits, 32 or 64.
+ *  32 bit ids are smaller, but collide often past a few tens of thousands
+ *  of strings ( about 50% odds at 77K ).  64 bit ids make accidental
+ *  collisions negligible at any realistic table size.
+ */
+#ifndef HASH_STRING_ID_BITS
+#define HASH_STRING_ID_BITS 32
+#endif
+
+#if HASH_STRING_ID_BITS != 32 && HASH_STRING_ID_BITS != 64
+#error "HASH_STRING_ID_BITS must be 32 or 64"
+#endif
+
+/// Values of HASH_STRING_HASH
+#define HASH_STRING_HASH_FNV1A 1
+#define HASH_STRING_HASH_XXHASH 2
+#define HASH_STRING_HASH_CRC32C 3
+
+/** \brief Hash that turns strings into StringIDs.
+ *  - HASH_STRING_HASH_FNV1A ( default ) - FNV-1a, fastest on short names,
+ *    and hashed in vector lanes by batch interning.
+ *  - HASH_STRING_HASH_XXHASH - XXH32 or XXH64, faster on longer strings.
+ *  - HASH_STRING_HASH_CRC32C - CRC32C, SSE4.2 accelerated, 32 bit ids only.
+ *  All are fully specified and computed the same way at compile time, so
+ *  ids are stable across platforms and standard libraries, but change
+ *  with this setting.
+ */
+#ifndef HASH_STRING_HASH
+#define HASH_STRING_HASH HASH_STRING_HASH_FNV1A
+#endif
+
+#if HASH_STRING_HASH != HASH_STRING_HASH_FNV1A && HASH_STRING_HASH != HASH_STRING_HASH_XXHASH \
+	&& HASH_STRING_HASH != HASH_STRING_HASH_CRC32C
+#error "HASH_STRING_HASH must be HASH_STRING_HASH_FNV1A, HASH_STRING_HASH_XXHASH or HASH_STRING_HASH_CRC32C"
+#endif
+
+#if HASH_STRING_HASH == HASH_STRING_HASH_CRC32C && HASH_STRING_ID_BITS != 32
+#error "HASH_STRING_HASH_CRC32C needs 32 bit StringIDs"
+#endif
+
+/** \brief Detect and resolve StringID collisions, 0 or 1.
+ *  When on, every interned string also stores a 32 bit check hash from a
+ *  second, unrelated hash function.  A string whose StringID is taken by a
+ *  different string ( check hash or length differ ) moves on to a derived
+ *  StringID instead of aliasing the other string, and the collision is
+ *  counted in HashString::getCollisionCount().
+ *  Interning costs a second hash of the text, but an already interned
+ *  string is recognised with integer compares only.
+ *  A string that had to move no longer has the StringID its compile time
+ *  literal ( _hs, HASH_STRING() ) has, and which of two colliding strings
+ *  moves depends on which was interned first, so its StringID is not
+ *  stable across processes.
+ */
+#ifndef HASH_STRING_RESOLVE_COLLISIONS
+#define HASH_STRING_RESOLVE_COLLISIONS 0
+#endif
+
+/** \brief Key collision handling with a secret per process seed, 0 or 1.
+ *  For tables that intern strings from untrusted sources.  The check hash
+ *  becomes SipHash keyed with a random seed, derived StringIDs depend on
+ *  it, and intern table slots are placed with a random multiplier, so no
+ *  one can craft strings that alias an interned string, pile onto one
+ *  derived id chain or cluster in the table.  StringIDs themselves are
+ *  unchanged and stay stable, compile time literals still work.
+ *  Needs HASH_STRING_RESOLVE_COLLISIONS.
+ */
+#ifndef HASH_STRING_SEEDED
+#define HASH_STRING_SEEDED 0
+#endif
+
+#if HASH_STRING_SEEDED && !HASH_STRING_RESOLVE_COLLISIONS
+#error "HASH_STRING_SEEDED needs HASH_STRING_RESOLVE_COLLISIONS"
+#endif
+
+/** \brief Make interning and lookups safe from any thread, 0 or 1.
+ *  The intern table is split into shards picked by the low bits of the
+ *  StringID, each behind its own mutex, so threads working on different
+ *  strings rarely wait on each other.
+ */
+#ifndef HASH_STRING_THREAD_SAFE
+#define HASH_STRING_THREAD_SAFE 0
+#endif
+
+/** \brief Log2 of the number of intern table shards, 0 to 8.
+ *  Defaults to 64 shards when thread safe and a single shard otherwise.
+ */
+#ifndef HASH_STRING_SHARD_BITS
+#if HASH_STRING_THREAD_SAFE
+#define HASH_STRING_SHARD_BITS 6
+#else
+#define HASH_STRING_SHARD_BITS 0
+#endif
+#endif
+
+#if HASH_STRING_SHARD_BITS < 0 || HASH_STRING_SHARD_BITS > 8
+#error "HASH_STRING_SHARD_BITS must be between 0 and 8"
+#endif
+
+/** \brief Number of strings the global intern table is sized for on first use.
+ *  Sizing it up front for the strings a program is known to intern ( say
+ *  HashString::getInternedCount() at the end of the last run ) means it
+ *  never grows, and never rehashes, while they are interned.  The
+ *  HASH_STRING_CAPACITY environment variable overrides it at run time,
+ *  when it is plain digits and a count HashString::reserve() takes.
+ *  0, the default, starts small and grows as needed.
+ */
+#ifndef HASH_STRING_INITIAL_CAPACITY
+#define HASH_STRING_INITIAL_CAPACITY 0
+#endif
+
+/** \brief Log2 of the per thread intern cache size, 0 to 16, 0 disables it.
+ *  Each thread keeps a small direct mapped cache from StringID to interned
+ *  string in front of the shared table, so interning the same names over
+ *  and over from one thread stays on that thread's cache lines.
+ */
+#ifndef HASH_STRING_THREAD_CACHE_BITS
+#define HASH_STRING_THREAD_CACHE_BITS 0
+#endif
+
+#if HASH_STRING_THREAD_CACHE_BITS < 0 || HASH_STRING_THREAD_CACHE_BITS > 16
+#error "HASH_STRING_THREAD_CACHE_BITS must be between 0 and 16"
+#endif
+
+#endif
@@ -0,0 +1,512 @@
+#include "InternTable.h"
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	/// Log2 of the initial slot count
+	unsigned const kInitialBits = 6;
+
+	/** \brief Log2 of the largest slot count.
+	 *  Enough slots for every index a 32 bit entry holds, and where size_t
+	 *  is narrower, small enough that the array's size in bytes fits it.
+	 */
+	unsigned const kMaxBits = std::numeric_limits< std::size_t >::digits > 40 ? 33 : std::numeric_limits< std::size_t >::digits - 5;
+
+	/// Candidate ids a string tries before interning fails, a chain can cycle back on itself
+	std::size_t const kMaxCandidates = 1024;
+
+	/** \brief Slots of the old array each insert copies while the table grows.
+	 *  The old array is at most 3/4 full and the new one twice its size,
+	 *  so the new one takes at least 3/4 of the old slot count in inserts
+	 *  before it grows again, and 2 per insert would do.  A few more finish
+	 *  sooner and keep lookups on one array most of the time.
+	 */
+	std::size_t const kMigrateSlots = 4;
+
+	/** \brief Multiplier homeSlot() spreads ids with.
+	 *  When seeded, a random odd one, which makes homeSlot() a universal hash:
+	 *  ids picked without knowing it share a slot no more often than chance.
+	 */
+	std::uint64_t slotMultiplier()
+	{
+#if HASH_STRING_SEEDED
+		static std::uint64_t const kMultiplier = SipHash::hash( StringHash::key(), "slot", 4 ) | 1;
+
+		return kMultiplier;
+#else
+		return 0x9E3779B97F4A7C15ull;
+#endif
+	}
+}
+
+/// Slots start all zero, which is empty, without clearing them up front
+InternTable::SlotArray::SlotArray( unsigned bits )
+:	m_count( std::size_t( 1 ) << bits ),
+	m_shift( 64 - bits ),
+	m_multiplier( slotMultiplier() ),
+	m_slots( static_cast< Slot * >( ZeroedMemory::allocate( ( std::size_t( 1 ) << bits ) * sizeof( Slot ) ) ) ),
+	m_source( nullptr )
+{
+}
+
+/// Multiplicative hashing, spreads ids with weak low bits across the table
+std::size_t InternTable::SlotArray::homeSlot( StringID id ) const
+{
+	return static_cast< std::size_t >(
+		( static_cast< std::uint64_t >( id ) * m_multiplier ) >> m_shift );
+}
+
+std::size_t InternTable::SlotArray::probe( StringID id ) const
+{
+	std::size_t pos = homeSlot( id );
+
+	while ( m_slots[pos].m_entry.load( std::memory_order_acquire ) != 0
+		&& m_slots[pos].m_key.load( std::memory_order_relaxed ) != id )
+	{
+		pos = ( pos + 1 ) & ( m_count - 1 );
+	}
+
+	return pos;
+}
+
+std::uint32_t InternTable::SlotArray::entry( StringID id ) const
+{
+	// Like probe(), but returns the entry it checked, the free slot it stops at may be filled right after
+	for ( std::size_t pos = homeSlot( id ); ; pos = ( pos + 1 ) & ( m_count - 1 ) )
+	{
+		std::uint32_t const entry = m_slots[pos].m_entry.load( std::memory_order_acquire );
+
+		if ( entry == 0 || m_slots[pos].m_key.load( std::memory_order_relaxed ) == id )
+		{
+			return entry;
+		}
+	}
+}
+
+void InternTable::SlotArray::place( StringID id, std::uint32_t entry )
+{
+	std::size_t pos = homeSlot( id );
+
+	while ( m_slots[pos].m_entry.load( std::memory_order_relaxed ) != 0 )
+	{
+		pos = ( pos + 1 ) & ( m_count - 1 );
+	}
+
+	fill( pos, id, entry );
+}
+
+void InternTable::SlotArray::fill( std::size_t pos, StringID id, std::uint32_t entry )
+{
+	// Key first, readers only look at it once they see the entry
+	m_slots[pos].m_key.store( id, std::memory_order_relaxed );
+	m_slots[pos].m_entry.store( entry, std::memory_order_release );
+}
+
+InternTable::Frozen::Frozen( StringID const * keys, std::uint32_t const * entries, std::size_t count )
+:	m_table( keys, entries, count )
+{
+}
+
+InternTable::Index InternTable::find( StringID id ) const
+{
+	std::uint32_t const found = entry( id );
+
+	return found != 0 ? found - 1 : StringIndex::kNoIndex;
+}
+
+std::uint32_t InternTable::entry( StringID id ) const
+{
+	SlotArray const * slots = m_current.load( std::memory_order_acquire );
+
+	if ( slots == nullptr )
+	{
+		return 0;
+	}
+
+	// Published before the array that replaced the frozen strings' slots, so it is there if they are gone
+	FrozenTable const * frozen = m_frozen.load( std::memory_order_acquire );
+
+	if ( frozen != nullptr )
+	{
+		std::uint32_t const found = frozen->find( id );
+
+		if ( found != 0 )
+		{
+			return found;
+		}
+	}
+
+	// Source first: once it is null, every entry it had is in slots
+	SlotArray const * source = slots->m_source.load( std::memory_order_acquire );
+	std::uint32_t const found = slots->entry( id );
+
+	return found == 0 && source != nullptr ? source->entry( id ) : found;
+}
+
+InternTable::Index InternTable::find( StringIndex const & index, StringID & id, char const * str, std::size_t length ) const
+{
+#if HASH_STRING_RESOLVE_COLLISIONS
+	return findChecked( index, id, check( str, length ), length );
+#else
+	( void )index;
+	( void )str;
+	( void )length;
+
+	return find( id );
+#endif
+}
+
+InternTable::Index InternTable::findChecked( StringIndex const & index, StringID & id, unsigned int check, std::size_t length ) const
+{
+#if HASH_STRING_RESOLVE_COLLISIONS
+	for ( std::size_t candidates = 0; candidates < kMaxCandidates; ++candidates )
+	{
+		Index const existing = find( id );
+
+		if ( existing == StringIndex::kNoIndex )
+		{
+			return existing;
+		}
+
+		// Integer compares only, a match on id, check and length is our string
+		char const * interned = index.get( existing );
+
+		if ( StringArena::check( interned ) == check && StringArena::length( interned ) == length )
+		{
+			return existing;
+		}
+
+		id = StringHash::nextCandidate( id, check );
+	}
+
+	throw std::runtime_error( "HashString: no free StringID for a colliding string" );
+#else
+	( void )index;
+	( void )check;
+	( void )length;
+
+	return find( id );
+#endif
+}
+
+InternTable::Index InternTable::insert( StringIndex & index, StringID & id, char const * str, std::size_t length )
+{
+	return insert( index, id, check( str, length ), str, length );
+}
+
+InternTable::Index InternTable::insert( StringIndex & index, StringID & id, unsigned int check, char const * str, std::size_t length )
+{
+	// Grow up front, so the slot the probe stops at is where a new string goes
+	if ( !m_newest || ( m_size - m_frozenSize + 1 ) * 4 > m_newest->m_count * 3 )
+	{
+		grow();
+	}
+
+	migrate( kMigrateSlots );
+
+	SlotArray & slots = *m_newest;
+	SlotArray const * source = slots.m_source.load( std::memory_order_relaxed );
+	FrozenTable const * frozen = m_frozen.load( std::memory_order_relaxed );
+	StringID const requested_id = id;
+	std::size_t pos;
+
+	for ( std::size_t candidates = 0; ; ++candidates )
+	{
+		if ( candidates == kMaxCandidates )
+		{
+			throw std::runtime_error( "HashString: no free StringID for a colliding string" );
+		}
+
+		pos = slots.probe( id );
+
+		std::uint32_t entry = slots.m_slots[pos].m_entry.load( std::memory_order_relaxed );
+
+		// Not copied over yet
+		if ( entry == 0 && source != nullptr )
+		{
+			entry = source->entry( id );
+		}
+
+		if ( entry == 0 && frozen != nullptr )
+		{
+			entry = frozen->find( id );
+		}
+
+		if ( entry == 0 )
+		{
+			break;
+		}
+
+#if HASH_STRING_RESOLVE_COLLISIONS
+		// Integer compares only, a match on id, check and length is our string
+		char const * interned = index.get( entry - 1 );
+
+		if ( StringArena::check( interned ) != check || StringArena::length( interned ) != length )
+		{
+			id = StringHash::nextCandidate( id, check );
+			continue;
+		}
+#endif
+
+		return entry - 1;
+	}
+
+	// May throw, so the table is only changed after
+	Index const added = index.add( m_arena.store( str, length, check ), id );
+
+	if ( id != requested_id )
+	{
+		++m_collisions;
+	}
+
+	slots.fill( pos, id, added + 1 );
+	++m_size;
+
+	return added;
+}
+
+void InternTable::adopt( StringID id, Index index )
+{
+	if ( !m_newest )
+	{
+		grow();
+	}
+
+	m_newest->place( id, index + 1 );
+	++m_size;
+}
+
+unsigned int InternTable::check( char const * str, std::size_t length )
+{
+#if HASH_STRING_RESOLVE_COLLISIONS
+	return StringHash::checkHash( str, length );
+#else
+	( void )str;
+	( void )length;
+
+	return 0;
+#endif
+}
+
+void InternTable::reserve( std::size_t count )
+{
+	// Only the strings that are not frozen take slots
+	count = count > m_frozenSize ? count - m_frozenSize : 0;
+
+	unsigned const current_bits = m_newest ? 64 - m_newest->m_shift : 0;
+	unsigned bits = current_bits > kInitialBits ? current_bits : kInitialBits;
+
+	if ( count > maxReserve() )
+	{
+		throw std::length_error( "HashString: cannot reserve room for that many strings" );
+	}
+
+	// Same load factor limit as insert()
+	while ( ( std::size_t( 1 ) << bits ) / 4 * 3 < count )
+	{
+		++bits;
+	}
+
+	if ( bits != current_bits )
+	{
+		grow( bits );
+	}
+}
+
+std::size_t InternTable::maxReserve()
+{
+	std::size_t const fits = ( std::size_t( 1 ) << kMaxBits ) / 4 * 3;
+
+	// Past StringIndex::kMaxSize the strings could not all get an index
+	return fits < StringIndex::kMaxSize ? fits : StringIndex::kMaxSize;
+}
+
+void InternTable::prefetch( StringID id ) const
+{
+#if defined( __GNUC__ )
+	FrozenTable const * frozen = m_frozen.load( std::memory_order_relaxed );
+
+	if ( frozen != nullptr )
+	{
+		frozen->prefetch( id );
+	}
+
+	SlotArray const * slots = m_current.load( std::memory_order_relaxed );
+
+	if ( slots != nullptr )
+	{
+		__builtin_prefetch( &slots->m_slots[ slots->homeSlot( id ) ] );
+	}
+#else
+	( void )id;
+#endif
+}
+
+void InternTable::grow()
+{
+	grow( m_newest ? 64 - m_newest->m_shift + 1 : kInitialBits );
+}
+
+void InternTable::grow( unsigned bits )
+{
+	std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+	std::unique_ptr< SlotArray > new_slots( new SlotArray( bits ) );
+
+	if ( m_newest )
+	{
+		// Finishes the last copy, only unfinished when reserve() grows it again right away
+		migrate( m_newest->m_count );
+
+		new_slots->m_source.store( m_newest.get(), std::memory_order_relaxed );
+		m_migrated = 0;
+	}
+
+	// Readers still on the old array see every entry it had, it is kept alive until copied, or for good when thread safe
+	new_slots->m_previous = std::move( m_newest );
+	m_newest = std::move( new_slots );
+	m_current.store( m_newest.get(), std::memory_order_release );
+
+	std::uint64_t const nanoseconds = std::chrono::duration_cast< std::chrono::nanoseconds >(
+		std::chrono::steady_clock::now() - start ).count();
+
+	++m_growth.m_count;
+	m_growth.m_nanoseconds += nanoseconds;
+
+	if ( nanoseconds > m_growth.m_maxNanoseconds )
+	{
+		m_growth.m_maxNanoseconds = nanoseconds;
+	}
+}
+
+void InternTable::migrate( std::size_t count )
+{
+	SlotArray & slots = *m_newest;
+	SlotArray const * source = slots.m_source.load( std::memory_order_relaxed );
+
+	if ( source == nullptr )
+	{
+		return;
+	}
+
+	std::size_t const end = count < source->m_count - m_migrated ? m_migrated + count : source->m_count;
+
+	for ( ; m_migrated < end; ++m_migrated )
+	{
+		std::uint32_t const entry = source->m_slots[ m_migrated ].m_entry.load( std::memory_order_relaxed );
+
+		if ( entry != 0 )
+		{
+			slots.place( source->m_slots[ m_migrated ].m_key.load( std::memory_order_relaxed ), entry );
+		}
+	}
+
+	if ( m_migrated == source->m_count )
+	{
+		slots.m_source.store( nullptr, std::memory_order_release );
+
+#if !HASH_STRING_THREAD_SAFE
+		// No other thread can still be reading it
+		slots.m_previous.reset();
+#endif
+	}
+}
+
+void InternTable::freeze()
+{
+	if ( m_size == m_frozenSize )
+	{
+		return;
+	}
+
+	std::vector< StringID > keys;
+	std::vector< std::uint32_t > entries;
+	keys.reserve( m_size );
+	entries.reserve( m_size );
+
+	if ( m_newestFrozen )
+	{
+		FrozenTable const & frozen = m_newestFrozen->m_table;
+
+		for ( std::size_t i = 0; i < frozen.size(); ++i )
+		{
+			keys.push_back( frozen.key( i ) );
+			entries.push_back( frozen.value( i ) );
+		}
+	}
+
+	migrate( m_newest->m_count );
+
+	SlotArray const & slots = *m_newest;
+
+	for ( std::size_t i = 0; i < slots.m_count; ++i )
+	{
+		std::uint32_t const entry = slots.m_slots[i].m_entry.load( std::memory_order_relaxed );
+
+		if ( entry != 0 )
+		{
+			keys.push_back( slots.m_slots[i].m_key.load( std::memory_order_relaxed ) );
+			entries.push_back( entry );
+		}
+	}
+
+	std::unique_ptr< Frozen > frozen( new Frozen( keys.data(), entries.data(), keys.size() ) );
+
+#if HASH_STRING_THREAD_SAFE
+	// Lookups may still be reading the tables this replaces, reclaim() frees them once none can be
+	frozen->m_previous = std::move( m_newestFrozen );
+#endif
+	m_newestFrozen = std::move( frozen );
+	m_frozen.store( &m_newestFrozen->m_table, std::memory_order_release );
+	m_frozenSize = m_size;
+
+	// Later strings go to a fresh array, published after the frozen table so lookups that see it see both
+	std::unique_ptr< SlotArray > overflow( new SlotArray( kInitialBits ) );
+
+#if HASH_STRING_THREAD_SAFE
+	overflow->m_previous = std::move( m_newest );
+#endif
+	m_newest = std::move( overflow );
+	m_current.store( m_newest.get(), std::memory_order_release );
+}
+
+void InternTable::reclaim()
+{
+	if ( m_newestFrozen )
+	{
+		m_newestFrozen->m_previous.reset();
+	}
+
+	// The array still being copied from stays, the ones before it go
+	SlotArray * keep = m_newest.get();
+
+	if ( keep != nullptr && keep->m_source.load( std::memory_order_relaxed ) != nullptr )
+	{
+		keep = keep->m_previous.get();
+	}
+
+	if ( keep != nullptr )
+	{
+		keep->m_previous.reset();
+	}
+}
+
+std::size_t InternTable::bytesReserved() const
+{
+	std::size_t bytes = m_arena.bytesReserved();
+
+	for ( Frozen const * frozen = m_newestFrozen.get(); frozen != nullptr; frozen = frozen->m_previous.get() )
+	{
+		bytes += frozen->m_table.bytesReserved();
+	}
+
+	for ( SlotArray const * slots = m_newest.get(); slots != nullptr; slots = slots->m_previous.get() )
+	{
+		bytes += slots->m_count * sizeof( Slot );
+	}
+
+	return bytes;
+}
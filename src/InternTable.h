@@ -0,0 +1,254 @@
+#ifndef INTERN_TABLE_H
+#define INTERN_TABLE_H
+
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "FrozenTable.h"
+#include "StringArena.h"
+#include "StringHash.h"
+#include "StringIndex.h"
+#include "ZeroedMemory.h"
+
+/** \brief Open addressing table of interned strings, keyed on StringID.
+ *  Slots live in one contiguous array and are placed with linear probing,
+ *  so a lookup touches a short run of adjacent slots instead of walking
+ *  tree nodes.  A slot is only the id and the string's StringIndex index,
+ *  the characters themselves are kept in a StringArena and never move.
+ *
+ *  Entries are never moved or removed once placed, and a slot is published
+ *  by storing its index last.  Growing replaces the slot array atomically
+ *  with one twice the size.  With HASH_STRING_THREAD_SAFE old arrays are
+ *  kept until reclaim() or until the table is destroyed, so the find()
+ *  functions never lock and are safe while one other thread at a time
+ *  calls insert().  Single threaded builds free an old array as soon as
+ *  its entries are copied.
+ *
+ *  Growing does not stop to rehash every entry: each insert() after it
+ *  copies the next few slots of the old array into the new one, and
+ *  until every slot has been copied lookups also check the old array.
+ *  The copy always finishes before the new array needs to grow again.
+ *
+ *  freeze() moves every string into a FrozenTable, a minimal perfect hash
+ *  that lookups check first, with a single probe.  Strings inserted after
+ *  that go to a new, small slot array, the slow path.  The slot arrays it
+ *  replaces are freed like old arrays are, see freeze().
+ *
+ *  The first slot array is only made by the first insert, and the
+ *  constructor is constexpr, so a table can be constant initialized.
+ *  Strings get their indices from a StringIndex the caller passes in,
+ *  which may be shared with other tables.
+ */
+class InternTable
+{
+public:
+	typedef StringIndex::Index Index;
+
+	/// Counters of slot array growth, see growthStats()
+	struct GrowthStats
+	{
+		/// Number of times a slot array was made or replaced, including by reserve()
+		std::size_t m_count;
+
+		/// Time the inserts that grew the table spent growing it, in total and the longest
+		std::uint64_t m_nanoseconds;
+		std::uint64_t m_maxNanoseconds;
+	};
+
+	constexpr InternTable()
+	:	m_current( nullptr ),
+		m_size( 0 ),
+		m_collisions( 0 ),
+		m_migrated( 0 ),
+		m_frozen( nullptr ),
+		m_frozenSize( 0 ),
+		m_growth()
+	{
+	}
+
+	/** \brief Finds the string interned under this id.
+	  * \param id StringID to look up
+	  * \return Index of the interned string, or StringIndex::kNoIndex if not interned.
+	  */
+	Index find( StringID id ) const;
+
+	/** \brief Finds the interned copy of this string.
+	  * \param index Array the table's strings were added to
+	  * \param id StringID of the string, updated to the id it is interned
+	  *     under when collisions are resolved
+	  * \param str Characters to look for
+	  * \param length Number of characters
+	  * \return Index of the interned string, or StringIndex::kNoIndex if not interned.
+	  * \throw std::runtime_error if every candidate id it tries is taken.
+	  */
+	Index find( StringIndex const & index, StringID & id, char const * str, std::size_t length ) const;
+
+	/// Same as find( StringIndex const &, StringID &, char const *, std::size_t ), with the string's check() already computed
+	Index findChecked( StringIndex const & index, StringID & id, unsigned int check, std::size_t length ) const;
+
+	/** \brief Interns the string under this id.
+	  * Probes once: the slot the lookup stops at is the one a new string
+	  * is placed in.
+	  * \param index Array a new string is added to
+	  * \param id StringID of the string, updated to the id it is interned
+	  *     under when collisions are resolved
+	  * \param str Characters to intern
+	  * \param length Number of characters
+	  * \return Index of the interned string. If the string is already
+	  *     interned the existing index is returned and nothing is added.
+	  *     Without HASH_STRING_RESOLVE_COLLISIONS a different string with
+	  *     the same id counts as already interned.
+	  * \throw std::runtime_error if every candidate id it tries is taken.
+	  * \throw std::length_error if index already holds StringIndex::kMaxSize strings,
+	  *     or length is over StringArena::kMaxLength.
+	  */
+	Index insert( StringIndex & index, StringID & id, char const * str, std::size_t length );
+
+	/// Same as insert( StringIndex &, StringID &, char const *, std::size_t ), with the string's check() already computed
+	Index insert( StringIndex & index, StringID & id, unsigned int check, char const * str, std::size_t length );
+
+	/** \brief Adds a string that is already in the StringIndex, under this id.
+	  * Only for an empty table, before any insert(), so id is free.
+	  */
+	void adopt( StringID id, Index index );
+
+	/** \brief Grows the slot array, if needed, so count strings fit without growing again.
+	  * \throw std::length_error if count is over maxReserve().
+	  * \throw std::bad_alloc if the slot array does not fit in memory.
+	  */
+	void reserve( std::size_t count );
+
+	/// Most strings reserve() makes room for, no more than StringIndex::kMaxSize
+	static std::size_t maxReserve();
+
+	/** \brief Moves every string into a FrozenTable, so looking one up never probes.
+	  * Strings inserted later go to a new slot array, checked after the
+	  * frozen table, and freezing again folds them in too.  Takes a few
+	  * hundred nanoseconds per string, safe alongside lookups like insert().
+	  * The slot array and frozen table it replaces are freed right away
+	  * without HASH_STRING_THREAD_SAFE, and by reclaim() with it.
+	  */
+	void freeze();
+
+	/** \brief Frees the slot arrays and frozen tables this table has replaced.
+	  * Only with HASH_STRING_THREAD_SAFE does the table keep them, for
+	  * lookups that may still be reading them, so only call it when no
+	  * lookup can be running.  An array still being copied from is kept.
+	  */
+	void reclaim();
+
+	/// Hints that id is about to be looked up, so its home slot is fetched early
+	void prefetch( StringID id ) const;
+
+	/// Check hash stored with a string, 0 without HASH_STRING_RESOLVE_COLLISIONS
+	static unsigned int check( char const * str, std::size_t length );
+
+	/// Length of an interned string
+	static std::size_t length( char const * interned ) { return StringArena::length( interned ); }
+
+	/// Number of interned strings
+	std::size_t size() const { return m_size; }
+
+	/// Number of strings interned under a derived id because theirs was taken
+	std::size_t collisions() const { return m_collisions; }
+
+	/// Bytes used by the slot arrays and the character arena
+	std::size_t bytesReserved() const;
+
+	/// Growth counters since the table was made
+	GrowthStats growthStats() const { return m_growth; }
+
+private:
+	InternTable( InternTable const & );
+	InternTable & operator=( InternTable const & );
+
+	/// Slot of the table, m_entry is the index + 1, 0 when empty, and stored last
+	struct Slot
+	{
+		std::atomic< StringID > m_key;
+		std::atomic< std::uint32_t > m_entry;
+	};
+
+	/// Power of two sized array of slots
+	struct SlotArray
+	{
+		explicit SlotArray( unsigned bits );
+
+		/// Home slot of this id
+		std::size_t homeSlot( StringID id ) const;
+
+		/// First slot from the home slot of id that holds id or is free
+		std::size_t probe( StringID id ) const;
+
+		/// Entry stored under id, 0 if there is none
+		std::uint32_t entry( StringID id ) const;
+
+		/// Stores the entry in the first free slot from its home slot
+		void place( StringID id, std::uint32_t entry );
+
+		/// Stores the entry in this free slot
+		void fill( std::size_t pos, StringID id, std::uint32_t entry );
+
+		std::size_t m_count;
+		unsigned m_shift;
+		std::uint64_t m_multiplier;
+		std::unique_ptr< Slot[], ZeroedMemory::Deleter > m_slots;
+
+		/// Array this one replaced, kept for lookups still reading it until reclaim(), or without HASH_STRING_THREAD_SAFE until it is copied
+		std::unique_ptr< SlotArray > m_previous;
+
+		/// m_previous while its entries are still being copied in, null once they all are
+		std::atomic< SlotArray const * > m_source;
+	};
+
+	/// A frozen table and, with HASH_STRING_THREAD_SAFE, the one it replaced, kept for lookups still reading it until reclaim()
+	struct Frozen
+	{
+		Frozen( StringID const * keys, std::uint32_t const * entries, std::size_t count );
+
+		FrozenTable m_table;
+		std::unique_ptr< Frozen > m_previous;
+	};
+
+	/// Entry stored under id in the frozen table, the current array or, while it is filled, the one it replaced
+	std::uint32_t entry( StringID id ) const;
+
+	/// Makes the first slot array, or replaces it with one twice the size
+	void grow();
+
+	/// Replaces the slot array with one of 2^bits slots, whose entries are copied in by later inserts
+	void grow( unsigned bits );
+
+	/// Copies up to count more slots of the array being replaced into m_newest
+	void migrate( std::size_t count );
+
+	/// Current slot array, owns the ones it replaced
+	std::unique_ptr< SlotArray > m_newest;
+
+	/// The array lookups use, m_newest once published, null until the first insert
+	std::atomic< SlotArray const * > m_current;
+
+	/// Backing storage for the characters, never moves them
+	StringArena m_arena;
+
+	std::size_t m_size;
+	std::size_t m_collisions;
+
+	/// Slots of m_newest->m_source copied so far
+	std::size_t m_migrated;
+
+	/// Latest frozen table, owns the ones it replaced
+	std::unique_ptr< Frozen > m_newestFrozen;
+
+	/// Table lookups check first, m_newestFrozen once published, null until the first freeze()
+	std::atomic< FrozenTable const * > m_frozen;
+
+	/// Strings in m_frozen, the rest are in the slot arrays
+	std::size_t m_frozenSize;
+
+	GrowthStats m_growth;
+};
+
+#endif
@@ -0,0 +1,256 @@
+#include "ShardedInternTable.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	/// How many strings ahead batch inserts prefetch slots
+	std::size_t const kPrefetchDistance = 8;
+
+	/// Strings one shard is sized for when count are spread over all of them
+	std::size_t shardShare( std::size_t count )
+	{
+		// Rounds up without adding to count first, which could wrap
+		std::size_t const share = count / ShardedInternTable::kShardCount + ( count % ShardedInternTable::kShardCount != 0 ? 1 : 0 );
+
+		// Shards are picked by id, so they fill unevenly, leave a few standard deviations of room.
+		// With two shards or more, share is at most half of SIZE_MAX, so this cannot wrap either
+		return ShardedInternTable::kShardCount == 1 ? share : share + share / 16 + 16;
+	}
+
+	/** \brief HASH_STRING_CAPACITY if it is set to a number the table can reserve, HASH_STRING_INITIAL_CAPACITY otherwise.
+	 *  strtoull() takes a leading minus and negates, so "-1" would be the
+	 *  largest value there is, only plain digits are read.
+	 */
+	std::size_t readInitialCapacity()
+	{
+		char const * value = std::getenv( "HASH_STRING_CAPACITY" );
+
+		if ( value != nullptr && *value >= '0' && *value <= '9' )
+		{
+			char * end;
+			errno = 0;
+			unsigned long long const capacity = std::strtoull( value, &end, 10 );
+
+			if ( *end == '\0' && errno != ERANGE && capacity <= StringIndex::kMaxSize
+				&& shardShare( static_cast< std::size_t >( capacity ) ) <= InternTable::maxReserve() )
+			{
+				return static_cast< std::size_t >( capacity );
+			}
+		}
+
+		return HASH_STRING_INITIAL_CAPACITY;
+	}
+}
+
+std::size_t const ShardedInternTable::kShardCount;
+ShardedInternTable::Index const ShardedInternTable::kEmptyIndex;
+StringID const ShardedInternTable::kEmptyId;
+
+ShardedInternTable::Index ShardedInternTable::find( StringID id ) const
+{
+	Index const found = shard( id ).m_table.find( id );
+
+	// Before its shard's first string the empty string is only in m_index
+	return found == StringIndex::kNoIndex && id == kEmptyId ? kEmptyIndex : found;
+}
+
+ShardedInternTable::Index ShardedInternTable::find( StringID & id, char const * str, std::size_t length ) const
+{
+	if ( length == 0 )
+	{
+		return kEmptyIndex;
+	}
+
+	return shard( id ).m_table.find( m_index, id, str, length );
+}
+
+ShardedInternTable::Index ShardedInternTable::insert( StringID & id, char const * str, std::size_t length )
+{
+	if ( length == 0 )
+	{
+		return kEmptyIndex;
+	}
+
+	Shard & target = shard( id );
+	unsigned int const check = InternTable::check( str, length );
+
+#if HASH_STRING_THREAD_SAFE
+	// Already interned strings never take the lock
+	StringID found_id = id;
+	Index const existing = target.m_table.findChecked( m_index, found_id, check, length );
+
+	if ( existing != StringIndex::kNoIndex )
+	{
+		id = found_id;
+		return existing;
+	}
+#endif
+
+	Lock lock( target.m_mutex );
+	prepare( target );
+
+	return target.m_table.insert( m_index, id, check, str, length );
+}
+
+void ShardedInternTable::insert( StringID * ids, char const * const * strs, std::size_t const * lengths, std::size_t count )
+{
+	std::vector< unsigned int > checks( count );
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		checks[i] = InternTable::check( strs[i], lengths[i] );
+	}
+
+	// Counting sort of the strings by shard, so each shard is visited once
+	std::size_t starts[ kShardCount + 1 ] = {};
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		++starts[ ( ids[i] & ( kShardCount - 1 ) ) + 1 ];
+	}
+
+	for ( std::size_t s = 0; s < kShardCount; ++s )
+	{
+		starts[ s + 1 ] += starts[s];
+	}
+
+	std::vector< std::size_t > order( count );
+	std::vector< std::size_t > next( starts, starts + kShardCount );
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		order[ next[ ids[i] & ( kShardCount - 1 ) ]++ ] = i;
+	}
+
+	for ( std::size_t s = 0; s < kShardCount; ++s )
+	{
+		if ( starts[s] == starts[ s + 1 ] )
+		{
+			continue;
+		}
+
+		Shard & target = m_shards[s];
+		Lock lock( target.m_mutex );
+		prepare( target );
+
+		// Sized for every string being new, already interned ones only leave it roomier
+		target.m_table.reserve( target.m_table.size() + ( starts[ s + 1 ] - starts[s] ) );
+
+		for ( std::size_t j = starts[s]; j < starts[ s + 1 ]; ++j )
+		{
+			// Slots are picked at random, fetch a few strings ahead to overlap the misses
+			if ( j + kPrefetchDistance < starts[ s + 1 ] )
+			{
+				target.m_table.prefetch( ids[ order[ j + kPrefetchDistance ] ] );
+			}
+
+			std::size_t const i = order[j];
+
+			if ( lengths[i] != 0 )
+			{
+				target.m_table.insert( m_index, ids[i], checks[i], strs[i], lengths[i] );
+			}
+		}
+	}
+}
+
+std::size_t ShardedInternTable::collisions() const
+{
+	std::size_t total = 0;
+
+	for ( std::size_t i = 0; i < kShardCount; ++i )
+	{
+		Lock lock( m_shards[i].m_mutex );
+		total += m_shards[i].m_table.collisions();
+	}
+
+	return total;
+}
+
+void ShardedInternTable::reserve( std::size_t count )
+{
+	// Checked before any shard grows, a share under InternTable::maxReserve() could still be more than the index holds
+	if ( count > StringIndex::kMaxSize )
+	{
+		throw std::length_error( "HashString: cannot reserve room for that many strings" );
+	}
+
+	std::size_t const share = shardShare( count );
+
+	for ( std::size_t i = 0; i < kShardCount; ++i )
+	{
+		Lock lock( m_shards[i].m_mutex );
+		m_shards[i].m_table.reserve( share );
+	}
+}
+
+InternTable::GrowthStats ShardedInternTable::growthStats() const
+{
+	InternTable::GrowthStats total = { 0, 0, 0 };
+
+	for ( std::size_t i = 0; i < kShardCount; ++i )
+	{
+		Lock lock( m_shards[i].m_mutex );
+		InternTable::GrowthStats const stats = m_shards[i].m_table.growthStats();
+
+		total.m_count += stats.m_count;
+		total.m_nanoseconds += stats.m_nanoseconds;
+
+		if ( stats.m_maxNanoseconds > total.m_maxNanoseconds )
+		{
+			total.m_maxNanoseconds = stats.m_maxNanoseconds;
+		}
+	}
+
+	return total;
+}
+
+void ShardedInternTable::freeze()
+{
+	for ( std::size_t i = 0; i < kShardCount; ++i )
+	{
+		Lock lock( m_shards[i].m_mutex );
+		m_shards[i].m_table.freeze();
+	}
+}
+
+void ShardedInternTable::reclaim()
+{
+	for ( std::size_t i = 0; i < kShardCount; ++i )
+	{
+		Lock lock( m_shards[i].m_mutex );
+		m_shards[i].m_table.reclaim();
+	}
+}
+
+void ShardedInternTable::prepare( Shard & target )
+{
+	if ( target.m_table.size() != 0 )
+	{
+		return;
+	}
+
+	std::size_t const capacity = initialCapacity();
+
+	if ( capacity != 0 )
+	{
+		target.m_table.reserve( shardShare( capacity ) );
+	}
+
+	if ( &target == &shard( kEmptyId ) )
+	{
+		target.m_table.adopt( kEmptyId, kEmptyIndex );
+	}
+}
+
+std::size_t ShardedInternTable::initialCapacity()
+{
+	// Read once, on the first string
+	static std::size_t const kCapacity = readInitialCapacity();
+
+	return kCapacity;
+}
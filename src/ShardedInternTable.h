@@ -0,0 +1,135 @@
+#ifndef SHARDED_INTERN_TABLE_H
+#define SHARDED_INTERN_TABLE_H
+
+#include <cstddef>
+#include <mutex>
+
+#include "HashStringConfig.h"
+#include "InternTable.h"
+
+/** \brief InternTable split into shards, each with its own lock.
+ *  The shard of a string is picked by the low HASH_STRING_SHARD_BITS bits
+ *  of its StringID, which collision resolution never changes.  Only
+ *  insert() takes the shard lock, lookups rely on InternTable being safe to
+ *  read while it is written to, and never lock.  Without
+ *  HASH_STRING_THREAD_SAFE the locks compile away.
+ *  All shards hand out indices from one StringIndex, so indices are dense
+ *  across the whole table.
+ *  The empty string is always interned, at kEmptyIndex, and the
+ *  constructor is constexpr and allocates nothing: a global table is
+ *  constant initialized, usable before any static initializer runs, and
+ *  only allocates as strings are interned.
+ */
+class ShardedInternTable
+{
+public:
+	typedef StringIndex::Index Index;
+
+	/// Number of shards
+	static std::size_t const kShardCount = std::size_t( 1 ) << HASH_STRING_SHARD_BITS;
+
+	/// Index of the empty string
+	static Index const kEmptyIndex = 0;
+
+	/// StringID of the empty string
+	static StringID const kEmptyId = StringHash::hashConstexpr( "", 0 );
+
+	constexpr ShardedInternTable();
+
+	/// See InternTable::find( StringID ), lock free
+	Index find( StringID id ) const;
+
+	/// See InternTable::find( StringIndex const &, StringID &, char const *, std::size_t ), lock free
+	Index find( StringID & id, char const * str, std::size_t length ) const;
+
+	/// See InternTable::insert()
+	Index insert( StringID & id, char const * str, std::size_t length );
+
+	/** \brief Interns count strings, locking each shard once.
+	  * \param ids StringID of each string, updated like insert() updates its id
+	  * \param strs Characters of each string
+	  * \param lengths Number of characters of each string
+	  * \param count Number of strings
+	  */
+	void insert( StringID * ids, char const * const * strs, std::size_t const * lengths, std::size_t count );
+
+	/// Null terminated string at this index, lock free
+	char const * string( Index index ) const { return m_index.get( index ); }
+
+	/// See StringIndex::entry(), lock free
+	char const * entry( Index index, StringID & id ) const { return m_index.entry( index, id ); }
+
+	/// Number of interned strings, lock free, see StringIndex::size()
+	std::size_t size() const { return m_index.size(); }
+
+	/// Number of strings interned under a derived id
+	std::size_t collisions() const;
+
+	/** \brief Sizes every shard so count strings in total fit without growing.
+	  * Shards only grow, so this never shrinks the table.
+	  * \throw std::length_error if count is over StringIndex::kMaxSize, nothing is grown then.
+	  * \throw std::bad_alloc if a shard's slot array does not fit in memory, the shards before it keep their new size.
+	  */
+	void reserve( std::size_t count );
+
+	/// Growth counters of all shards, m_maxNanoseconds is the longest of any shard
+	InternTable::GrowthStats growthStats() const;
+
+	/// See InternTable::freeze(), freezes each shard in turn
+	void freeze();
+
+	/// See InternTable::reclaim(), for each shard in turn
+	void reclaim();
+
+private:
+#if HASH_STRING_THREAD_SAFE
+	typedef std::mutex Mutex;
+#else
+	/// Stand in for std::mutex in single threaded builds
+	struct Mutex
+	{
+		void lock() {}
+		void unlock() {}
+	};
+#endif
+
+	typedef std::lock_guard< Mutex > Lock;
+
+	ShardedInternTable( ShardedInternTable const & );
+	ShardedInternTable & operator=( ShardedInternTable const & );
+
+	/// A lock and the table it guards, on cache lines of their own
+	struct alignas( 64 ) Shard
+	{
+		mutable Mutex m_mutex;
+		InternTable m_table;
+	};
+
+	Shard & shard( StringID id ) { return m_shards[ id & ( kShardCount - 1 ) ]; }
+	Shard const & shard( StringID id ) const { return m_shards[ id & ( kShardCount - 1 ) ]; }
+
+	/** \brief Readies a shard for its first string.
+	  * Sizes it for its share of initialCapacity(), and adds the empty
+	  * string to its owner shard, so no other string takes its id.
+	  */
+	void prepare( Shard & target );
+
+	/** \brief Number of strings the table is sized for on first use.
+	  * The HASH_STRING_CAPACITY environment variable when it is set to a
+	  * number, HASH_STRING_INITIAL_CAPACITY otherwise.
+	  */
+	static std::size_t initialCapacity();
+
+	StringArena::EmptyRecord m_empty;
+	StringIndex m_index;
+	Shard m_shards[ kShardCount ];
+};
+
+constexpr ShardedInternTable::ShardedInternTable()
+:	m_empty(),
+	m_index( m_empty.text(), kEmptyId ),
+	m_shards()
+{
+}
+
+#endif
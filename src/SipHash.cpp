@@ -0,0 +1,119 @@
+#include "HashStringConfig.h"
+
+// Only built into the library when collision handling is seeded
+#if HASH_STRING_SEEDED
+
+#include "SipHash.h"
+
+#include <cstring>
+
+namespace
+{
+	/// Rounds per 8 byte word of input
+	unsigned const kCompressionRounds = 1;
+
+	/// Rounds after the last word
+	unsigned const kFinalizationRounds = 3;
+
+	inline std::uint64_t rotate( std::uint64_t value, unsigned bits )
+	{
+		return ( value << bits ) | ( value >> ( 64 - bits ) );
+	}
+
+	/// Word of str, read little endian as the reference does
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || defined( _M_X64 ) || defined( _M_IX86 )
+	inline std::uint64_t load64( char const * str )
+	{
+		std::uint64_t word;
+		std::memcpy( &word, str, sizeof( word ) );
+
+		return word;
+	}
+#else
+	inline std::uint64_t load64( char const * str )
+	{
+		std::uint64_t word = 0;
+
+		for ( unsigned i = 0; i < 8; ++i )
+		{
+			word |= std::uint64_t( static_cast< unsigned char >( str[i] ) ) << ( 8 * i );
+		}
+
+		return word;
+	}
+#endif
+
+	/// The four word state of SipHash
+	struct State
+	{
+		explicit State( SipHash::Key const & key )
+		:	m_v0( key.m_k0 ^ 0x736F6D6570736575ull ),
+			m_v1( key.m_k1 ^ 0x646F72616E646F6Dull ),
+			m_v2( key.m_k0 ^ 0x6C7967656E657261ull ),
+			m_v3( key.m_k1 ^ 0x7465646279746573ull )
+		{
+		}
+
+		void rounds( unsigned count )
+		{
+			for ( unsigned i = 0; i < count; ++i )
+			{
+				m_v0 += m_v1;
+				m_v1 = rotate( m_v1, 13 );
+				m_v1 ^= m_v0;
+				m_v0 = rotate( m_v0, 32 );
+				m_v2 += m_v3;
+				m_v3 = rotate( m_v3, 16 );
+				m_v3 ^= m_v2;
+				m_v0 += m_v3;
+				m_v3 = rotate( m_v3, 21 );
+				m_v3 ^= m_v0;
+				m_v2 += m_v1;
+				m_v1 = rotate( m_v1, 17 );
+				m_v1 ^= m_v2;
+				m_v2 = rotate( m_v2, 32 );
+			}
+		}
+
+		void compress( std::uint64_t word )
+		{
+			m_v3 ^= word;
+			rounds( kCompressionRounds );
+			m_v0 ^= word;
+		}
+
+		std::uint64_t m_v0;
+		std::uint64_t m_v1;
+		std::uint64_t m_v2;
+		std::uint64_t m_v3;
+	};
+}
+
+std::uint64_t SipHash::hash( Key const & key, char const * str, std::size_t length )
+{
+	State state( key );
+
+	char const * const end = str + ( length & ~std::size_t( 7 ) );
+
+	for ( ; str != end; str += 8 )
+	{
+		state.compress( load64( str ) );
+	}
+
+	// Last word holds the leftover bytes and the length in its top byte
+	std::uint64_t last = std::uint64_t( length ) << 56;
+
+	for ( std::size_t i = 0; i < ( length & 7 ); ++i )
+	{
+		last |= std::uint64_t( static_cast< unsigned char >( str[i] ) ) << ( 8 * i );
+	}
+
+	state.compress( last );
+
+	state.m_v2 ^= 0xFF;
+	state.rounds( kFinalizationRounds );
+
+	return state.m_v0 ^ state.m_v1 ^ state.m_v2 ^ state.m_v3;
+}
+
+#endif
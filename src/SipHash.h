@@ -0,0 +1,32 @@
+#ifndef SIP_HASH_H
+#define SIP_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/** \brief SipHash-1-3, a keyed hash for input that may be hostile.
+ *  Without the key, which strings collide cannot be predicted, so no one
+ *  can craft a set of strings that piles up on the same check hash or
+ *  table slot.  Used when HASH_STRING_SEEDED is on, see StringHash::key().
+ *  One compression and three finalization rounds, as in most hash tables
+ *  that use SipHash, rather than the 2-4 of the reference.
+ */
+namespace SipHash
+{
+	/// 128 bit key
+	struct Key
+	{
+		std::uint64_t m_k0;
+		std::uint64_t m_k1;
+	};
+
+	/** \brief Hashes the characters under key.
+	  * \param key Secret key
+	  * \param str Characters to hash
+	  * \param length Number of characters
+	  * \return 64 bit hash, the same on every platform for the same key.
+	  */
+	std::uint64_t hash( Key const & key, char const * str, std::size_t length );
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include "StringArena.h"
+
+#include <stdexcept>
+
+namespace
+{
+	/// Size of a regular arena page
+	std::size_t const kPageSize = 64 * 1024;
+
+	/// Records larger than this get a page of their own
+	std::size_t const kLargeRecord = kPageSize / 4;
+}
+
+std::size_t const StringArena::kHeaderSize;
+std::size_t const StringArena::kMaxLength;
+
+StringArena::~StringArena()
+{
+	while ( m_lastPage != nullptr )
+	{
+		char * previous;
+		std::memcpy( &previous, m_lastPage, sizeof( previous ) );
+
+		delete [] m_lastPage;
+		m_lastPage = previous;
+	}
+}
+
+char * StringArena::allocatePage( std::size_t bytes )
+{
+	char * page = new char[ sizeof( char * ) + bytes ];
+
+	std::memcpy( page, &m_lastPage, sizeof( m_lastPage ) );
+	m_lastPage = page;
+	m_bytesReserved += sizeof( char * ) + bytes;
+
+	return page + sizeof( char * );
+}
+
+char const * StringArena::store( char const * str, std::size_t length, std::uint32_t check )
+{
+	// The length would be cut to 32 bits, and the string read back short
+	if ( length > kMaxLength )
+	{
+		throw std::length_error( "HashString: string too long to intern" );
+	}
+
+	std::uint32_t const stored_length = static_cast< std::uint32_t >( length );
+	std::size_t const record = sizeof( check ) + sizeof( stored_length ) + length + 1;
+
+	char * dest;
+
+	if ( record > kLargeRecord )
+	{
+		// Keep the current page for small strings
+		dest = allocatePage( record );
+	}
+	else
+	{
+		if ( record > static_cast< std::size_t >( m_end - m_cursor ) )
+		{
+			m_cursor = allocatePage( kPageSize );
+			m_end = m_cursor + kPageSize;
+		}
+
+		dest = m_cursor;
+		m_cursor += record;
+	}
+
+	m_bytesUsed += record;
+
+	std::memcpy( dest, &check, sizeof( check ) );
+	dest += sizeof( check );
+
+	std::memcpy( dest, &stored_length, sizeof( stored_length ) );
+	dest += sizeof( stored_length );
+
+	std::memcpy( dest, str, length );
+	dest[ length ] = '\0';
+
+	return dest;
+}
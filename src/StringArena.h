@@ -0,0 +1,106 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/** \brief Bump allocator for interned string characters.
+ *  Strings are appended into large pages that are never moved or freed
+ *  until the arena itself is destroyed, so a stored string is addressed by
+ *  a single pointer for the lifetime of the arena.  Each record is laid out
+ *  as a 32 bit check word, a 32 bit length, the characters, then a null
+ *  terminator.  The check word is for the owner, the arena only stores it.
+ *  Nothing is allocated until the first store(), and the constructor is
+ *  constexpr, so an arena can be constant initialized.
+ */
+class StringArena
+{
+public:
+	/// Bytes in front of the characters of a record
+	static std::size_t const kHeaderSize = 2 * sizeof( std::uint32_t );
+
+	/// Longest string a record's 32 bit length holds
+	static std::size_t const kMaxLength = 0xFFFFFFFFu;
+
+	/** \brief Record of the empty string, laid out like the ones store() makes.
+	  * For a table that holds "" from the start, before it may allocate.
+	  * Its check word is 0.
+	  */
+	struct EmptyRecord
+	{
+		constexpr EmptyRecord() : m_bytes() {}
+
+		/// The empty string, as store() would return it
+		constexpr char const * text() const { return m_bytes + kHeaderSize; }
+
+		char m_bytes[ kHeaderSize + 1 ];
+	};
+
+	constexpr StringArena()
+	:	m_lastPage( nullptr ),
+		m_cursor( nullptr ),
+		m_end( nullptr ),
+		m_bytesReserved( 0 ),
+		m_bytesUsed( 0 )
+	{
+	}
+
+	~StringArena();
+
+	/** \brief Copies the characters into the arena.
+	  * \param str Characters to copy
+	  * \param length Number of characters
+	  * \param check Check word stored with the record
+	  * \return Pointer to the null terminated copy.
+	  * \throw std::length_error if length is over kMaxLength, nothing is stored then.
+	  * \throw std::bad_alloc if a new page is needed and there is no memory.
+	  */
+	char const * store( char const * str, std::size_t length, std::uint32_t check = 0 );
+
+	/// Length of a string returned by store()
+	static std::size_t length( char const * stored );
+
+	/// Check word of a string returned by store()
+	static std::uint32_t check( char const * stored );
+
+	/// Bytes requested from the heap for pages
+	std::size_t bytesReserved() const { return m_bytesReserved; }
+
+	/// Bytes taken up by stored records
+	std::size_t bytesUsed() const { return m_bytesUsed; }
+
+private:
+	StringArena( StringArena const & );
+	StringArena & operator=( StringArena const & );
+
+	/// Allocates a page with room for at least this many bytes
+	char * allocatePage( std::size_t bytes );
+
+	/// Most recent page, each page starts with a pointer to the one before it
+	char * m_lastPage;
+
+	char * m_cursor;
+	char * m_end;
+
+	std::size_t m_bytesReserved;
+	std::size_t m_bytesUsed;
+};
+
+inline std::size_t StringArena::length( char const * stored )
+{
+	std::uint32_t length;
+	std::memcpy( &length, stored - sizeof( length ), sizeof( length ) );
+
+	return length;
+}
+
+inline std::uint32_t StringArena::check( char const * stored )
+{
+	std::uint32_t check;
+	std::memcpy( &check, stored - sizeof( std::uint32_t ) - sizeof( check ), sizeof( check ) );
+
+	return check;
+}
+
+#endif
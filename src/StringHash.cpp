@@ -0,0 +1,313 @@
+#include "StringHash.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if HASH_STRING_SEEDED
+#include <chrono>
+#include <random>
+#endif
+
+/// AVX2 FNV-1a kernel for 32 bit ids, GCC on x86, the only combination it measured faster on
+#if HASH_STRING_HASH == HASH_STRING_HASH_FNV1A && HASH_STRING_ID_BITS == 32 \
+	&& defined( __GNUC__ ) && !defined( __clang__ ) \
+	&& ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define HASH_STRING_AVX2_HASH 1
+#else
+#define HASH_STRING_AVX2_HASH 0
+#endif
+
+// Golden StringIDs.  Saved and transmitted ids depend on these, a change
+// to any hash that breaks one of them needs a new HASH_STRING_HASH value
+#if HASH_STRING_HASH == HASH_STRING_HASH_FNV1A && HASH_STRING_ID_BITS == 64
+static_assert( StringHash::hashConstexpr( "", 0 ) == 0xCBF29CE484222325ull, "FNV-1a 64 changed" );
+static_assert( StringHash::hashConstexpr( "a", 1 ) == 0xAF63DC4C8601EC8Cull, "FNV-1a 64 changed" );
+static_assert( StringHash::hashConstexpr( "123456789", 9 ) == 0x06D5573923C6CDFCull, "FNV-1a 64 changed" );
+static_assert( StringHash::hashConstexpr( "The quick brown fox jumps over the lazy dog", 43 ) == 0xF3F9B7F5E7E47110ull, "FNV-1a 64 changed" );
+#elif HASH_STRING_HASH == HASH_STRING_HASH_FNV1A
+static_assert( StringHash::hashConstexpr( "", 0 ) == 0x811C9DC5u, "FNV-1a 32 changed" );
+static_assert( StringHash::hashConstexpr( "a", 1 ) == 0xE40C292Cu, "FNV-1a 32 changed" );
+static_assert( StringHash::hashConstexpr( "123456789", 9 ) == 0xBB86B11Cu, "FNV-1a 32 changed" );
+static_assert( StringHash::hashConstexpr( "The quick brown fox jumps over the lazy dog", 43 ) == 0x048FFF90u, "FNV-1a 32 changed" );
+#elif HASH_STRING_HASH == HASH_STRING_HASH_XXHASH && HASH_STRING_ID_BITS == 64
+static_assert( StringHash::hashConstexpr( "", 0 ) == 0xEF46DB3751D8E999ull, "XXH64 changed" );
+static_assert( StringHash::hashConstexpr( "a", 1 ) == 0xD24EC4F1A98C6E5Bull, "XXH64 changed" );
+static_assert( StringHash::hashConstexpr( "123456789", 9 ) == 0x8CB841DB40E6AE83ull, "XXH64 changed" );
+static_assert( StringHash::hashConstexpr( "The quick brown fox jumps over the lazy dog", 43 ) == 0x0B242D361FDA71BCull, "XXH64 changed" );
+#elif HASH_STRING_HASH == HASH_STRING_HASH_XXHASH
+static_assert( StringHash::hashConstexpr( "", 0 ) == 0x02CC5D05u, "XXH32 changed" );
+static_assert( StringHash::hashConstexpr( "a", 1 ) == 0x550D7456u, "XXH32 changed" );
+static_assert( StringHash::hashConstexpr( "123456789", 9 ) == 0x937BAD67u, "XXH32 changed" );
+static_assert( StringHash::hashConstexpr( "The quick brown fox jumps over the lazy dog", 43 ) == 0xE85EA4DEu, "XXH32 changed" );
+#elif HASH_STRING_HASH == HASH_STRING_HASH_CRC32C
+static_assert( StringHash::hashConstexpr( "", 0 ) == 0x00000000u, "CRC32C changed" );
+static_assert( StringHash::hashConstexpr( "a", 1 ) == 0xC1D04330u, "CRC32C changed" );
+static_assert( StringHash::hashConstexpr( "123456789", 9 ) == 0xE3069283u, "CRC32C changed" );
+static_assert( StringHash::hashConstexpr( "The quick brown fox jumps over the lazy dog", 43 ) == 0x22620404u, "CRC32C changed" );
+#endif
+
+namespace
+{
+	/// Hashes strings one after the other
+	void hashScalar( char const * const * strs, std::size_t const * lengths, std::size_t count, StringID * ids )
+	{
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ids[i] = StringHash::hash( strs[i], lengths[i] );
+		}
+	}
+}
+
+#if HASH_STRING_AVX2_HASH
+// Everything up to pop_options is compiled for AVX2 and only runs when the CPU has it
+#pragma GCC push_options
+#pragma GCC target( "avx2" )
+
+namespace
+{
+	/// One StringID per lane, 8 lanes
+	typedef StringID Lanes __attribute__(( vector_size( 32 ) ));
+
+	std::size_t const kLanes = sizeof( Lanes ) / sizeof( StringID );
+
+	/// Strings hashLanes() hashes at once, two vectors so one hides the latency of the other
+	std::size_t const kWidth = kLanes * 2;
+
+	/// Characters past the mean length of a group still hashed in vector lanes
+	std::size_t const kTailSlack = 16;
+
+	/// 4 characters of str from offset, which must all be in the string
+	inline std::uint32_t loadFullWord( char const * str, std::size_t offset )
+	{
+		std::uint32_t word;
+		std::memcpy( &word, str + offset, 4 );
+
+		return word;
+	}
+
+	/** \brief Characters of str from offset in the low bytes, never reads past the end.
+	 *  Only the bytes before the end of the string are meaningful, the
+	 *  caller masks off the rest.  Strings of 4 or more characters load the
+	 *  last whole word at or before offset and shift, so there is no branch
+	 *  to mispredict on every string.
+	 */
+	inline std::uint32_t loadWord( char const * str, std::size_t length, std::size_t offset )
+	{
+		std::uint32_t word = 0;
+
+		if ( length >= 4 )
+		{
+			std::size_t const start = offset < length - 4 ? offset : length - 4;
+			std::size_t const skip = offset - start < 3 ? offset - start : 3;
+
+			std::memcpy( &word, str + start, 4 );
+
+			return word >> ( 8 * skip );
+		}
+
+		for ( std::size_t i = offset; i < length; ++i )
+		{
+			word |= std::uint32_t( static_cast< unsigned char >( str[i] ) ) << ( 8 * ( i - offset ) );
+		}
+
+		return word;
+	}
+
+	// Lanes are filled from an initializer, storing them and reloading as a vector stalls on store forwarding
+
+	/// loadFullWord() of each lane's string
+	inline Lanes loadFullWords( char const * const * strs, std::size_t offset )
+	{
+		Lanes const words = {
+			loadFullWord( strs[0], offset ), loadFullWord( strs[1], offset ),
+			loadFullWord( strs[2], offset ), loadFullWord( strs[3], offset ),
+			loadFullWord( strs[4], offset ), loadFullWord( strs[5], offset ),
+			loadFullWord( strs[6], offset ), loadFullWord( strs[7], offset ) };
+
+		return words;
+	}
+
+	/// loadWord() of each lane's string
+	inline Lanes loadWords( char const * const * strs, std::size_t const * lengths, std::size_t offset )
+	{
+		Lanes const words = {
+			loadWord( strs[0], lengths[0], offset ), loadWord( strs[1], lengths[1], offset ),
+			loadWord( strs[2], lengths[2], offset ), loadWord( strs[3], lengths[3], offset ),
+			loadWord( strs[4], lengths[4], offset ), loadWord( strs[5], lengths[5], offset ),
+			loadWord( strs[6], lengths[6], offset ), loadWord( strs[7], lengths[7], offset ) };
+
+		return words;
+	}
+
+	/// Length of each lane's string
+	inline Lanes loadLengths( std::size_t const * lengths )
+	{
+		Lanes const length = {
+			StringID( lengths[0] ), StringID( lengths[1] ), StringID( lengths[2] ), StringID( lengths[3] ),
+			StringID( lengths[4] ), StringID( lengths[5] ), StringID( lengths[6] ), StringID( lengths[7] ) };
+
+		return length;
+	}
+
+	/// hash * Fnv1aHash::kPrime as shifts and adds, kPrime is 2^24 + 0x193 and vector multiplies are slow
+	inline Lanes multiplyPrime( Lanes hash )
+	{
+		return hash + ( hash << 1 ) + ( hash << 4 )
+			+ ( hash << 7 ) + ( hash << 8 ) + ( hash << 24 );
+	}
+
+	/// Four FNV-1a steps on every lane, one per character packed in words
+	inline Lanes hashWord( Lanes hash, Lanes words )
+	{
+		hash = multiplyPrime( hash ^ ( words & 0xFF ) );
+		hash = multiplyPrime( hash ^ ( ( words >> 8 ) & 0xFF ) );
+		hash = multiplyPrime( hash ^ ( ( words >> 16 ) & 0xFF ) );
+
+		return multiplyPrime( hash ^ ( words >> 24 ) );
+	}
+
+	/// One FNV-1a step on every lane whose string has a character at position
+	inline Lanes hashStep( Lanes hash, Lanes words, unsigned shift, Lanes length, StringID position )
+	{
+		Lanes const active = reinterpret_cast< Lanes >( Lanes() + position < length );
+		Lanes const next = multiplyPrime( hash ^ ( ( words >> shift ) & 0xFF ) );
+
+		return ( next & active ) | ( hash & ~active );
+	}
+
+	/** \brief Hashes kWidth strings side by side, one per lane.
+	 *  Each lane runs plain FNV-1a over its own string, so the results match
+	 *  StringHash::hash() exactly.  Up to the shortest string every lane
+	 *  hashes every character, after it lanes past the end of their string
+	 *  are masked off and keep their hash.  Well past the mean length most
+	 *  lanes would be masked off, so the longest strings finish one by one.
+	 */
+	void hashLanes( char const * const * strs, std::size_t const * lengths, StringID * ids )
+	{
+		std::size_t shortest = lengths[0];
+		std::size_t longest = 0;
+		std::size_t total = 0;
+
+		for ( std::size_t k = 0; k < kWidth; ++k )
+		{
+			shortest = lengths[k] < shortest ? lengths[k] : shortest;
+			longest = lengths[k] > longest ? lengths[k] : longest;
+			total += lengths[k];
+		}
+
+		std::size_t const tail_start = total / kWidth + kTailSlack;
+		std::size_t const vector_end = longest < tail_start ? longest : tail_start;
+
+		Lanes hash_a = Lanes() + Fnv1aHash::kOffsetBasis;
+		Lanes hash_b = hash_a;
+
+		std::size_t offset = 0;
+
+		for ( ; offset + 4 <= shortest; offset += 4 )
+		{
+			hash_a = hashWord( hash_a, loadFullWords( strs, offset ) );
+			hash_b = hashWord( hash_b, loadFullWords( strs + kLanes, offset ) );
+		}
+
+		if ( offset < vector_end )
+		{
+			Lanes const length_a = loadLengths( lengths );
+			Lanes const length_b = loadLengths( lengths + kLanes );
+
+			for ( ; offset < vector_end; offset += 4 )
+			{
+				Lanes const words_a = loadWords( strs, lengths, offset );
+				Lanes const words_b = loadWords( strs + kLanes, lengths + kLanes, offset );
+				StringID const position = static_cast< StringID >( offset );
+
+				for ( unsigned b = 0; b < 4; ++b )
+				{
+					hash_a = hashStep( hash_a, words_a, 8 * b, length_a, position + b );
+					hash_b = hashStep( hash_b, words_b, 8 * b, length_b, position + b );
+				}
+			}
+		}
+
+		std::memcpy( ids, &hash_a, sizeof( Lanes ) );
+		std::memcpy( ids + kLanes, &hash_b, sizeof( Lanes ) );
+
+		for ( std::size_t k = 0; k < kWidth; ++k )
+		{
+			for ( std::size_t i = offset; i < lengths[k]; ++i )
+			{
+				ids[k] = ( ids[k] ^ static_cast< unsigned char >( strs[k][i] ) ) * Fnv1aHash::kPrime;
+			}
+		}
+	}
+
+	/// Hashes whole groups of kWidth strings with hashLanes(), the rest one by one
+	void hashAvx2( char const * const * strs, std::size_t const * lengths, std::size_t count, StringID * ids )
+	{
+		std::size_t i = 0;
+
+		for ( ; i + kWidth <= count; i += kWidth )
+		{
+			hashLanes( strs + i, lengths + i, ids + i );
+		}
+
+		hashScalar( strs + i, lengths + i, count - i, ids + i );
+	}
+}
+
+#pragma GCC pop_options
+#endif
+
+namespace
+{
+	typedef void ( * HashKernel )( char const * const *, std::size_t const *, std::size_t, StringID * );
+
+	/// Best kernel for the CPU we run on
+	HashKernel pickKernel()
+	{
+#if HASH_STRING_AVX2_HASH
+		__builtin_cpu_init();
+
+		if ( __builtin_cpu_supports( "avx2" ) )
+		{
+			return hashAvx2;
+		}
+#endif
+
+		return hashScalar;
+	}
+}
+
+#if HASH_STRING_SEEDED
+namespace
+{
+	/// Key from the system's random source
+	SipHash::Key randomKey()
+	{
+		std::random_device device;
+
+		// Some standard libraries give a fixed sequence from random_device, the clock makes up for it
+		std::uint64_t const time = static_cast< std::uint64_t >(
+			std::chrono::high_resolution_clock::now().time_since_epoch().count() );
+
+		SipHash::Key key;
+		key.m_k0 = ( std::uint64_t( device() ) << 32 | device() ) ^ time;
+		key.m_k1 = ( std::uint64_t( device() ) << 32 | device() ) ^ ( time * 0x9E3779B97F4A7C15ull );
+
+		return key;
+	}
+}
+
+SipHash::Key const & StringHash::key()
+{
+	static SipHash::Key const kKey = randomKey();
+
+	return kKey;
+}
+#endif
+
+void StringHash::hash( char const * const * strs, std::size_t const * lengths, std::size_t count, StringID * ids )
+{
+	static HashKernel const kernel = pickKernel();
+
+	kernel( strs, lengths, count, ids );
+}
@@ -0,0 +1,193 @@
+#ifndef STRING_HASH_H
+#define STRING_HASH_H
+
+#include <cstddef>
+
+#include "HashStringConfig.h"
+#include "StringID.h"
+
+#if HASH_STRING_SEEDED
+#include "SipHash.h"
+#endif
+
+#if HASH_STRING_HASH == HASH_STRING_HASH_XXHASH
+#include "XxHash.h"
+#elif HASH_STRING_HASH == HASH_STRING_HASH_CRC32C
+#include "Crc32cHash.h"
+#else
+#include "Fnv1aHash.h"
+#endif
+
+/** \brief Hash used to turn strings into StringIDs, picked by HASH_STRING_HASH.
+ *  Every choice is fully specified, so the same string gets the same
+ *  StringID at compile time and at run time, on every platform.
+ *  StringIDs are stable: a build with the same kIdScheme gives every
+ *  string the same StringID, whatever the compiler, standard library or
+ *  byte order, so they can be saved and sent in place of the string.
+ *  Strings are hashed as their bytes in order, with no seed.  Golden
+ *  values are checked at compile time in StringHash.cpp.
+ */
+namespace StringHash
+{
+#if HASH_STRING_HASH == HASH_STRING_HASH_XXHASH
+	namespace Policy = XxHash;
+#elif HASH_STRING_HASH == HASH_STRING_HASH_CRC32C
+	namespace Policy = Crc32cHash;
+#else
+	namespace Policy = Fnv1aHash;
+#endif
+
+	/** \brief Compile time hash.
+	  * \param str Characters to hash
+	  * \param length Number of characters
+	  * \return StringID of the characters.
+	  * \note Slow at run time, use hash() there.
+	  */
+	constexpr StringID hashConstexpr( char const * str, std::size_t length )
+	{
+		return Policy::hashConstexpr( str, length );
+	}
+
+	/// Run time hash, same result as hashConstexpr()
+	inline StringID hash( char const * str, std::size_t length )
+	{
+		return Policy::hash( str, length );
+	}
+
+	/** \brief Identifies how StringIDs are computed, the hash and the id width.
+	  * Only StringIDs saved under the same scheme can be compared, store it
+	  * in file and protocol headers next to the ids.
+	  */
+	unsigned int const kIdScheme = HASH_STRING_HASH * 0x100u + HASH_STRING_ID_BITS;
+
+	/// Bytes store() writes
+	std::size_t const kIdBytes = HASH_STRING_ID_BITS / 8;
+
+	/** \brief Writes id as kIdBytes bytes, least significant first.
+	  * The same on every platform, read back with load().
+	  */
+	inline void store( StringID id, unsigned char * bytes )
+	{
+		for ( std::size_t i = 0; i < kIdBytes; ++i )
+		{
+			bytes[i] = static_cast< unsigned char >( id >> ( 8 * i ) );
+		}
+	}
+
+	/// Reads a StringID written by store()
+	inline StringID load( unsigned char const * bytes )
+	{
+		StringID id = 0;
+
+		for ( std::size_t i = 0; i < kIdBytes; ++i )
+		{
+			id |= StringID( bytes[i] ) << ( 8 * i );
+		}
+
+		return id;
+	}
+
+	/** \brief Hashes count strings at once, same results as hash() on each.
+	  * With FNV-1a and 32 bit ids, hashes several strings side by side in
+	  * vector lanes when the CPU supports AVX2, checked at run time.
+	  * \param strs Characters of each string
+	  * \param lengths Number of characters of each string
+	  * \param count Number of strings
+	  * \param ids Receives the StringID of each string
+	  */
+	void hash( char const * const * strs, std::size_t const * lengths, std::size_t count, StringID * ids );
+
+#if HASH_STRING_SEEDED
+	/** \brief Secret key of this process, drawn from std::random_device on first use.
+	  * Seeds checkHash() and the intern table's slot placement.
+	  */
+	SipHash::Key const & key();
+
+	/** \brief Check hash used to tell apart strings with the same StringID.
+	  * SipHash keyed with key(), so which strings collide here is unknown
+	  * outside the process.
+	  */
+	inline unsigned int checkHash( char const * str, std::size_t length )
+	{
+		return static_cast< unsigned int >( SipHash::hash( key(), str, length ) );
+	}
+#else
+	/** \brief Check hash used to tell apart strings with the same StringID.
+	  * Unrelated to the StringID hash, so strings that collide on their StringID
+	  * almost never collide here too.
+	  */
+	inline unsigned int checkHash( char const * str, std::size_t length )
+	{
+		unsigned int check = 0x9747B28Cu;
+
+		for ( std::size_t i = 0; i < length; ++i )
+		{
+			check = ( check ^ static_cast< unsigned char >( str[i] ) ) * 0x5BD1E995u;
+			check ^= check >> 15;
+		}
+
+		return check;
+	}
+#endif
+
+	/** \brief Next StringID to try when id is taken by a different string.
+	  * Depends on the string's checkHash() as well, so strings sharing a
+	  * StringID each follow their own chain of candidates instead of all
+	  * walking the same one.  Keeps the low 8 bits of id, so the candidate
+	  * lands in the same intern table shard.
+	  */
+	inline StringID nextCandidate( StringID id, unsigned int check )
+	{
+		StringID mixed = ( id ^ ( id >> 16 ) ^ ( StringID( check ) * 0x9E3779B9u ) ) * 0x45D9F3Bu;
+		mixed ^= mixed >> 16;
+
+		return ( mixed & ~StringID( 0xFF ) ) | ( id & StringID( 0xFF ) );
+	}
+}
+
+/** \brief A string literal and its StringID, computed at compile time.
+ *  Converts to StringID in constant expressions, so it can be used for
+ *  switch cases and template arguments.  Constructing a HashString from it
+ *  interns the literal without hashing it again.
+ *  \code
+ *	switch ( event_type.getHashValue() )
+ *	{
+ *		case "PlayerMove"_hs:
+ *			...
+ *	}
+ *	\endcode
+ */
+class HashStringLiteral
+{
+public:
+	constexpr HashStringLiteral( char const * str, std::size_t length )
+	:	m_string( str ),
+		m_length( length ),
+		m_hashValue( StringHash::hashConstexpr( str, length ) )
+	{
+	}
+
+	constexpr char const * getString() const { return m_string; }
+
+	constexpr std::size_t getLength() const { return m_length; }
+
+	constexpr StringID getHashValue() const { return m_hashValue; }
+
+	constexpr operator StringID() const { return m_hashValue; }
+
+private:
+	char const * m_string;
+	std::size_t m_length;
+	StringID m_hashValue;
+};
+
+/// Compile time HashStringLiteral, "PlayerMove"_hs
+constexpr HashStringLiteral operator"" _hs( char const * str, std::size_t length )
+{
+	return HashStringLiteral( str, length );
+}
+
+/// Compile time HashStringLiteral for a string literal, HASH_STRING( "PlayerMove" )
+#define HASH_STRING( str ) ( HashStringLiteral( ( str ), sizeof( str ) - 1 ) )
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef STRING_ID_H
+#define STRING_ID_H
+
+#include <climits>
+
+#include "HashStringConfig.h"
+
+#if HASH_STRING_ID_BITS == 64
+/// Unique String Identifier
+typedef unsigned long long StringID;
+#else
+/// Unique String Identifier
+typedef unsigned int StringID;
+#endif
+
+static_assert( sizeof( StringID ) * CHAR_BIT == HASH_STRING_ID_BITS, "StringID must be exactly HASH_STRING_ID_BITS wide" );
+
+#endif
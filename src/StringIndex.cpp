@@ -0,0 +1,91 @@
+#include "StringIndex.h"
+#include "ZeroedMemory.h"
+
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+
+StringIndex::Index const StringIndex::kNoIndex;
+std::size_t const StringIndex::kMaxSize;
+
+StringIndex::~StringIndex()
+{
+	// Chunk 0 is m_firstChunk
+	for ( unsigned i = 1; i < kChunkCount; ++i )
+	{
+		ZeroedMemory::release( m_chunks[i].load( std::memory_order_relaxed ) );
+	}
+}
+
+StringIndex::Entry * StringIndex::chunk( unsigned n )
+{
+	Entry * existing = m_chunks[n].load( std::memory_order_acquire );
+
+	if ( existing != nullptr )
+	{
+		return existing;
+	}
+
+	// Two threads may race to allocate the same chunk, the loser frees its copy
+	Entry * allocated = static_cast< Entry * >( ZeroedMemory::allocate( ( std::size_t( 1 ) << ( n + kFirstChunkBits ) ) * sizeof( Entry ) ) );
+
+	if ( m_chunks[n].compare_exchange_strong( existing, allocated, std::memory_order_acq_rel ) )
+	{
+		return allocated;
+	}
+
+	ZeroedMemory::release( allocated );
+
+	return existing;
+}
+
+StringIndex::Index StringIndex::add( char const * str, StringID id )
+{
+	std::size_t index = m_size.load( std::memory_order_relaxed );
+	unsigned n;
+	std::size_t offset;
+	Entry * entries;
+
+	// The chunk is made before the index is claimed, so allocating can throw but a claimed index is always published
+	do
+	{
+		// The next index would be kNoIndex, or wrap to 0
+		if ( index >= kMaxSize )
+		{
+			throw std::length_error( "HashString: every StringIndex index is taken" );
+		}
+
+		locate( static_cast< Index >( index ), n, offset );
+		entries = chunk( n );
+	}
+	while ( !m_size.compare_exchange_weak( index, index + 1, std::memory_order_acq_rel, std::memory_order_relaxed ) );
+
+	Entry & added = entries[ offset ];
+	added.m_id = id;
+	added.m_string.store( str, std::memory_order_release );
+
+	return static_cast< Index >( index );
+}
+
+char const * StringIndex::entry( Index index, StringID & id ) const
+{
+	assert( index < size() && "StringIndex::entry() past the end" );
+
+	unsigned n;
+	std::size_t offset;
+	locate( index, n, offset );
+
+	// Its chunk was made before the index was claimed, but the string is stored after, wait for it
+	Entry const * entries = m_chunks[n].load( std::memory_order_acquire );
+	char const * str = entries[ offset ].m_string.load( std::memory_order_acquire );
+
+	while ( str == nullptr )
+	{
+		std::this_thread::yield();
+		str = entries[ offset ].m_string.load( std::memory_order_acquire );
+	}
+
+	id = entries[ offset ].m_id;
+
+	return str;
+}
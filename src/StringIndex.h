@@ -0,0 +1,135 @@
+#ifndef STRING_INDEX_H
+#define STRING_INDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "StringHash.h"
+
+/** \brief Dense, append only array of interned strings.
+ *  Every interned string gets the next index, starting at 0, and keeps it
+ *  for the lifetime of the array.  Storage is a list of chunks that double
+ *  in size and never move, so get() is safe alongside add() from other
+ *  threads, and indices can be used to address side arrays directly.
+ *  Because indices are dense and never reused, size() is a snapshot of the
+ *  array: indices below it stay valid and keep their string forever.
+ *  The first chunk is part of the array itself, so the array can be
+ *  constant initialized and allocates nothing for its first strings.
+ */
+class StringIndex
+{
+public:
+	/// Index of an interned string
+	typedef std::uint32_t Index;
+
+	/// Not an index, returned by lookups that found nothing
+	static Index const kNoIndex = 0xFFFFFFFFu;
+
+	/// Most strings an array holds, every Index below kNoIndex
+	static std::size_t const kMaxSize = kNoIndex;
+
+	/** \brief Array that already holds one string, at index 0.
+	  * \param first Null terminated string at index 0, must outlive the array
+	  * \param first_id StringID of first
+	  */
+	constexpr StringIndex( char const * first, StringID first_id );
+
+	~StringIndex();
+
+	/** \brief Appends a string, safe from any thread.
+	  * \param str Null terminated interned string, must outlive the array
+	  * \param id StringID the string is interned under
+	  * \return Index of the string.
+	  * \throw std::bad_alloc if a new chunk is needed and there is no memory, nothing is added then.
+	  * \throw std::length_error if the array already holds kMaxSize strings.
+	  */
+	Index add( char const * str, StringID id );
+
+	/** \brief Returns the string at this index.
+	  * \param index Index returned by add(), handed to this thread through
+	  *     something that orders it after add() ( a lock, or an atomic
+	  *     release / acquire such as the intern table's slots )
+	  */
+	char const * get( Index index ) const;
+
+	/** \brief Returns the string and StringID at any index below size().
+	  * Unlike get(), the index may come from size() alone, if another
+	  * thread is still adding it this waits for the add() to finish.
+	  * Asserts that index is below size().
+	  */
+	char const * entry( Index index, StringID & id ) const;
+
+	/// Number of indices handed out so far
+	std::size_t size() const { return m_size.load( std::memory_order_acquire ); }
+
+private:
+	StringIndex( StringIndex const & );
+	StringIndex & operator=( StringIndex const & );
+
+	/// Log2 of the size of the first chunk
+	static unsigned const kFirstChunkBits = 10;
+
+	/// Chunk n holds 2^( n + kFirstChunkBits ) strings, enough chunks for every Index
+	static unsigned const kChunkCount = 32 - kFirstChunkBits + 1;
+
+	/// m_id is written before m_string is published
+	struct Entry
+	{
+		/// All zero, so chunks from ZeroedMemory need no constructing
+		constexpr Entry() : m_string( nullptr ), m_id( 0 ) {}
+		constexpr Entry( char const * string, StringID id ) : m_string( string ), m_id( id ) {}
+
+		std::atomic< char const * > m_string;
+		StringID m_id;
+	};
+
+	/// Splits an index into its chunk and the offset in that chunk
+	static void locate( Index index, unsigned & chunk, std::size_t & offset );
+
+	/// Chunk n, allocating it if no thread has yet
+	Entry * chunk( unsigned n );
+
+	std::atomic< Entry * > m_chunks[ kChunkCount ];
+	std::atomic< std::size_t > m_size;
+
+	/// Chunk 0
+	Entry m_firstChunk[ std::size_t( 1 ) << kFirstChunkBits ];
+};
+
+constexpr StringIndex::StringIndex( char const * first, StringID first_id )
+:	m_chunks{ { m_firstChunk } },
+	m_size( 1 ),
+	m_firstChunk{ { first, first_id } }
+{
+}
+
+inline void StringIndex::locate( Index index, unsigned & chunk, std::size_t & offset )
+{
+	std::uint64_t const biased = std::uint64_t( index ) + ( std::uint64_t( 1 ) << kFirstChunkBits );
+
+	// Position of the highest set bit picks the chunk
+#if defined( __GNUC__ )
+	unsigned const top_bit = 63 - __builtin_clzll( biased );
+#else
+	unsigned top_bit = 0;
+	while ( ( biased >> top_bit ) > 1 )
+	{
+		++top_bit;
+	}
+#endif
+
+	chunk = top_bit - kFirstChunkBits;
+	offset = static_cast< std::size_t >( biased - ( std::uint64_t( 1 ) << top_bit ) );
+}
+
+inline char const * StringIndex::get( Index index ) const
+{
+	unsigned chunk;
+	std::size_t offset;
+	locate( index, chunk, offset );
+
+	return m_chunks[ chunk ].load( std::memory_order_acquire )[ offset ].m_string.load( std::memory_order_acquire );
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "HashStringConfig.h"
+
+// Only built into the library when it is the string hash
+#if HASH_STRING_HASH == HASH_STRING_HASH_XXHASH
+
+#include "XxHash.h"
+
+#include <cstring>
+
+namespace
+{
+	// Whole word loads where the byte order allows, the reference reads little endian
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || defined( _M_X64 ) || defined( _M_IX86 )
+	inline std::uint32_t load32( char const * str )
+	{
+		std::uint32_t word;
+		std::memcpy( &word, str, sizeof( word ) );
+
+		return word;
+	}
+
+	inline std::uint64_t load64( char const * str )
+	{
+		std::uint64_t word;
+		std::memcpy( &word, str, sizeof( word ) );
+
+		return word;
+	}
+#else
+	inline std::uint32_t load32( char const * str )
+	{
+		return XxHash::read32( str );
+	}
+
+	inline std::uint64_t load64( char const * str )
+	{
+		return std::uint64_t( XxHash::read32( str ) ) | std::uint64_t( XxHash::read32( str + 4 ) ) << 32;
+	}
+#endif
+}
+
+#if HASH_STRING_ID_BITS == 64
+StringID XxHash::hash( char const * str, std::size_t length )
+{
+	char const * const end = str + length;
+	std::uint64_t hash_value;
+
+	if ( length >= 32 )
+	{
+		std::uint64_t v1 = kPrime1 + kPrime2;
+		std::uint64_t v2 = kPrime2;
+		std::uint64_t v3 = 0;
+		std::uint64_t v4 = 0 - kPrime1;
+
+		for ( char const * const limit = end - 32; str <= limit; str += 32 )
+		{
+			v1 = round( v1, load64( str ) );
+			v2 = round( v2, load64( str + 8 ) );
+			v3 = round( v3, load64( str + 16 ) );
+			v4 = round( v4, load64( str + 24 ) );
+		}
+
+		hash_value = mergeAccumulators( v1, v2, v3, v4 );
+	}
+	else
+	{
+		hash_value = kPrime5;
+	}
+
+	hash_value += length;
+
+	for ( ; str + 8 <= end; str += 8 )
+	{
+		hash_value = rotate( hash_value ^ round( 0, load64( str ) ), 27 ) * kPrime1 + kPrime4;
+	}
+
+	if ( str + 4 <= end )
+	{
+		hash_value = rotate( hash_value ^ ( load32( str ) * kPrime1 ), 23 ) * kPrime2 + kPrime3;
+		str += 4;
+	}
+
+	for ( ; str < end; ++str )
+	{
+		hash_value = rotate( hash_value ^ ( static_cast< unsigned char >( *str ) * kPrime5 ), 11 ) * kPrime1;
+	}
+
+	return avalanche( hash_value );
+}
+#else
+StringID XxHash::hash( char const * str, std::size_t length )
+{
+	char const * const end = str + length;
+	std::uint32_t hash_value;
+
+	if ( length >= 16 )
+	{
+		std::uint32_t v1 = kPrime1 + kPrime2;
+		std::uint32_t v2 = kPrime2;
+		std::uint32_t v3 = 0;
+		std::uint32_t v4 = 0 - kPrime1;
+
+		for ( char const * const limit = end - 16; str <= limit; str += 16 )
+		{
+			v1 = round( v1, load32( str ) );
+			v2 = round( v2, load32( str + 4 ) );
+			v3 = round( v3, load32( str + 8 ) );
+			v4 = round( v4, load32( str + 12 ) );
+		}
+
+		hash_value = rotate( v1, 1 ) + rotate( v2, 7 ) + rotate( v3, 12 ) + rotate( v4, 18 );
+	}
+	else
+	{
+		hash_value = kPrime5;
+	}
+
+	hash_value += static_cast< std::uint32_t >( length );
+
+	for ( ; str + 4 <= end; str += 4 )
+	{
+		hash_value = rotate( hash_value + load32( str ) * kPrime3, 17 ) * kPrime4;
+	}
+
+	for ( ; str < end; ++str )
+	{
+		hash_value = rotate( hash_value + static_cast< unsigned char >( *str ) * kPrime5, 11 ) * kPrime1;
+	}
+
+	return avalanche( hash_value );
+}
+#endif
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef XX_HASH_H
+#define XX_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "StringID.h"
+
+/** \brief xxHash, XXH32 or XXH64 to match StringID, with a seed of 0.
+ *  Selected with HASH_STRING_HASH.  Reads 4 or 8 bytes at a time, so it
+ *  pulls ahead of FNV-1a as strings get longer, and matches the reference
+ *  implementation byte for byte on every platform.
+ */
+namespace XxHash
+{
+	/// Little endian read of 4 bytes, usable in constant expressions
+	constexpr std::uint32_t read32( char const * str )
+	{
+		return std::uint32_t( static_cast< unsigned char >( str[0] ) )
+			| std::uint32_t( static_cast< unsigned char >( str[1] ) ) << 8
+			| std::uint32_t( static_cast< unsigned char >( str[2] ) ) << 16
+			| std::uint32_t( static_cast< unsigned char >( str[3] ) ) << 24;
+	}
+
+#if HASH_STRING_ID_BITS == 64
+	std::uint64_t const kPrime1 = 11400714785074694791ull;
+	std::uint64_t const kPrime2 = 14029467366897019727ull;
+	std::uint64_t const kPrime3 = 1609587929392839161ull;
+	std::uint64_t const kPrime4 = 9650029242287828579ull;
+	std::uint64_t const kPrime5 = 2870177450012600261ull;
+
+	constexpr std::uint64_t rotate( std::uint64_t value, unsigned bits )
+	{
+		return ( value << bits ) | ( value >> ( 64 - bits ) );
+	}
+
+	/// Little endian read of 8 bytes, usable in constant expressions
+	constexpr std::uint64_t read64( char const * str )
+	{
+		return std::uint64_t( read32( str ) ) | std::uint64_t( read32( str + 4 ) ) << 32;
+	}
+
+	constexpr std::uint64_t round( std::uint64_t acc, std::uint64_t input )
+	{
+		return rotate( acc + input * kPrime2, 31 ) * kPrime1;
+	}
+
+	constexpr std::uint64_t mergeRound( std::uint64_t hash, std::uint64_t acc )
+	{
+		return ( hash ^ round( 0, acc ) ) * kPrime1 + kPrime4;
+	}
+
+	constexpr std::uint64_t mergeAccumulators( std::uint64_t v1, std::uint64_t v2, std::uint64_t v3, std::uint64_t v4 )
+	{
+		return mergeRound( mergeRound( mergeRound( mergeRound(
+			rotate( v1, 1 ) + rotate( v2, 7 ) + rotate( v3, 12 ) + rotate( v4, 18 ),
+			v1 ), v2 ), v3 ), v4 );
+	}
+
+	/// Hash of the 32 byte stripes, stripes is the number left
+	constexpr std::uint64_t stripesConstexpr( char const * str, std::size_t stripes,
+		std::uint64_t v1, std::uint64_t v2, std::uint64_t v3, std::uint64_t v4 )
+	{
+		return stripes == 0
+			? mergeAccumulators( v1, v2, v3, v4 )
+			: stripesConstexpr( str + 32, stripes - 1,
+				round( v1, read64( str ) ), round( v2, read64( str + 8 ) ),
+				round( v3, read64( str + 16 ) ), round( v4, read64( str + 24 ) ) );
+	}
+
+	/// Folds in the last length % 32 bytes
+	constexpr std::uint64_t tailConstexpr( char const * str, std::size_t length, std::uint64_t hash )
+	{
+		return length >= 8
+			? tailConstexpr( str + 8, length - 8, rotate( hash ^ round( 0, read64( str ) ), 27 ) * kPrime1 + kPrime4 )
+			: length >= 4
+			? tailConstexpr( str + 4, length - 4, rotate( hash ^ ( read32( str ) * kPrime1 ), 23 ) * kPrime2 + kPrime3 )
+			: length > 0
+			? tailConstexpr( str + 1, length - 1, rotate( hash ^ ( static_cast< unsigned char >( *str ) * kPrime5 ), 11 ) * kPrime1 )
+			: hash;
+	}
+
+	constexpr std::uint64_t avalanche3( std::uint64_t hash ) { return hash ^ ( hash >> 32 ); }
+	constexpr std::uint64_t avalanche2( std::uint64_t hash ) { return avalanche3( ( hash ^ ( hash >> 29 ) ) * kPrime3 ); }
+	constexpr std::uint64_t avalanche( std::uint64_t hash ) { return avalanche2( ( hash ^ ( hash >> 33 ) ) * kPrime2 ); }
+
+	/// Compile time XXH64, recursive so it is a valid C++11 constexpr function
+	constexpr StringID hashConstexpr( char const * str, std::size_t length )
+	{
+		return avalanche( tailConstexpr( str + ( length & ~std::size_t( 31 ) ), length & 31,
+			( length >= 32
+				? stripesConstexpr( str, length / 32, kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1 )
+				: kPrime5 ) + length ) );
+	}
+#else
+	std::uint32_t const kPrime1 = 2654435761u;
+	std::uint32_t const kPrime2 = 2246822519u;
+	std::uint32_t const kPrime3 = 3266489917u;
+	std::uint32_t const kPrime4 = 668265263u;
+	std::uint32_t const kPrime5 = 374761393u;
+
+	constexpr std::uint32_t rotate( std::uint32_t value, unsigned bits )
+	{
+		return ( value << bits ) | ( value >> ( 32 - bits ) );
+	}
+
+	constexpr std::uint32_t round( std::uint32_t acc, std::uint32_t input )
+	{
+		return rotate( acc + input * kPrime2, 13 ) * kPrime1;
+	}
+
+	/// Hash of the 16 byte stripes, stripes is the number left
+	constexpr std::uint32_t stripesConstexpr( char const * str, std::size_t stripes,
+		std::uint32_t v1, std::uint32_t v2, std::uint32_t v3, std::uint32_t v4 )
+	{
+		return stripes == 0
+			? rotate( v1, 1 ) + rotate( v2, 7 ) + rotate( v3, 12 ) + rotate( v4, 18 )
+			: stripesConstexpr( str + 16, stripes - 1,
+				round( v1, read32( str ) ), round( v2, read32( str + 4 ) ),
+				round( v3, read32( str + 8 ) ), round( v4, read32( str + 12 ) ) );
+	}
+
+	/// Folds in the last length % 16 bytes
+	constexpr std::uint32_t tailConstexpr( char const * str, std::size_t length, std::uint32_t hash )
+	{
+		return length >= 4
+			? tailConstexpr( str + 4, length - 4, rotate( hash + read32( str ) * kPrime3, 17 ) * kPrime4 )
+			: length > 0
+			? tailConstexpr( str + 1, length - 1, rotate( hash + static_cast< unsigned char >( *str ) * kPrime5, 11 ) * kPrime1 )
+			: hash;
+	}
+
+	constexpr std::uint32_t avalanche3( std::uint32_t hash ) { return hash ^ ( hash >> 16 ); }
+	constexpr std::uint32_t avalanche2( std::uint32_t hash ) { return avalanche3( ( hash ^ ( hash >> 13 ) ) * kPrime3 ); }
+	constexpr std::uint32_t avalanche( std::uint32_t hash ) { return avalanche2( ( hash ^ ( hash >> 15 ) ) * kPrime2 ); }
+
+	/// Compile time XXH32, recursive so it is a valid C++11 constexpr function
+	constexpr StringID hashConstexpr( char const * str, std::size_t length )
+	{
+		return avalanche( tailConstexpr( str + ( length & ~std::size_t( 15 ) ), length & 15,
+			( length >= 16
+				? stripesConstexpr( str, length / 16, kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1 )
+				: kPrime5 ) + static_cast< std::uint32_t >( length ) ) );
+	}
+#endif
+
+	/// Run time xxHash, same result as hashConstexpr()
+	StringID hash( char const * str, std::size_t length );
+}
+
+#endif
@@ -0,0 +1,44 @@
+#include "ZeroedMemory.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined( __linux__ )
+#include <sys/mman.h>
+
+namespace
+{
+	/// Size and alignment of a huge page
+	std::uintptr_t const kHugePageSize = std::uintptr_t( 1 ) << 21;
+}
+#endif
+
+void * ZeroedMemory::allocate( std::size_t bytes )
+{
+	// Large blocks are mapped fresh from the OS, so calloc() need not clear them
+	void * block = std::calloc( bytes, 1 );
+
+	if ( block == nullptr )
+	{
+		throw std::bad_alloc();
+	}
+
+#if defined( __linux__ ) && defined( MADV_HUGEPAGE )
+	// Only whole huge pages inside the block, a hint that may be ignored
+	std::uintptr_t const first = ( reinterpret_cast< std::uintptr_t >( block ) + kHugePageSize - 1 ) & ~( kHugePageSize - 1 );
+	std::uintptr_t const last = ( reinterpret_cast< std::uintptr_t >( block ) + bytes ) & ~( kHugePageSize - 1 );
+
+	if ( first < last )
+	{
+		madvise( reinterpret_cast< void * >( first ), last - first, MADV_HUGEPAGE );
+	}
+#endif
+
+	return block;
+}
+
+void ZeroedMemory::release( void * block )
+{
+	std::free( block );
+}
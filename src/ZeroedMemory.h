@@ -0,0 +1,34 @@
+#ifndef ZEROED_MEMORY_H
+#define ZEROED_MEMORY_H
+
+#include <cstddef>
+
+/** \brief Large zero filled blocks that cost nothing up front.
+ *  Slot arrays and index chunks grow to hundreds of megabytes, and
+ *  clearing one when it is allocated stalls the insert that needed it for
+ *  tens of milliseconds.  These come from the OS already zeroed, their
+ *  pages are faulted in as they are first used, and on Linux they are
+ *  backed by huge pages where possible, so there are few faults and the
+ *  random accesses of a hash table miss the TLB less.
+ */
+namespace ZeroedMemory
+{
+	/** \brief Allocates a zero filled block.
+	  * Only for types that are valid when all zero and need no constructor.
+	  * \param bytes Size of the block
+	  * \return The block, free it with release().
+	  * \throw std::bad_alloc if there is no memory.
+	  */
+	void * allocate( std::size_t bytes );
+
+	/// Frees a block from allocate(), nullptr is ignored
+	void release( void * block );
+
+	/// Deleter for a std::unique_ptr that owns a block
+	struct Deleter
+	{
+		void operator()( void * block ) const { release( block ); }
+	};
+}
+
+#endif
@@ -0,0 +1,97 @@
+/** \brief Interning a std::string allocates nothing per string.
+ *  Counts operator new calls, which is what copying a std::string or
+ *  making a node per string would go through.  A new string's characters
+ *  go into the arena's 64 KB pages, so interning many new names takes a
+ *  page now and then and nothing per name, and interning or looking up
+ *  names that are already interned allocates nothing at all.  The slot
+ *  arrays and index chunks come from ZeroedMemory, not operator new, and
+ *  double in size, so they are few either way.
+ */
+
+#include "HashString.h"
+#include "TestCheck.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::atomic< std::size_t > s_allocations( 0 );
+}
+
+void * operator new( std::size_t bytes )
+{
+	s_allocations.fetch_add( 1, std::memory_order_relaxed );
+
+	void * block = std::malloc( bytes != 0 ? bytes : 1 );
+
+	if ( block == nullptr )
+	{
+		throw std::bad_alloc();
+	}
+
+	return block;
+}
+
+void * operator new[]( std::size_t bytes )
+{
+	return operator new( bytes );
+}
+
+void operator delete( void * block ) noexcept
+{
+	std::free( block );
+}
+
+void operator delete[]( void * block ) noexcept
+{
+	std::free( block );
+}
+
+int main()
+{
+	std::size_t const count = 100000;
+	std::vector< std::string > names( count );
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		names[i] = "Entity/Component/Mesh_" + std::to_string( i ) + ".material";
+	}
+
+	std::size_t before = s_allocations.load();
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		HashString::internString( names[i] );
+	}
+
+	std::size_t const new_strings = s_allocations.load() - before;
+
+	// About 40 bytes a name, so a 64 KB page every 1500 or so
+	TEST_CHECK( new_strings < count / 500 );
+
+	before = s_allocations.load();
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		HashString const handle( names[i] );
+		HashString const slice( names[i].data(), names[i].size() );
+		HashString found;
+
+		TEST_CHECK( HashString::tryFind( names[i], found ) );
+		TEST_CHECK( handle == slice && handle == found );
+	}
+
+	std::size_t const interned_strings = s_allocations.load() - before;
+
+	TEST_CHECK( interned_strings == 0 );
+
+	std::printf( "operator new calls: %zu interning %zu new names, %zu interning and finding them again\n",
+		new_strings, count, interned_strings );
+
+	return TestCheck::exitCode();
+}
@@ -0,0 +1,154 @@
+#ifndef COLLISION_SETS_H
+#define COLLISION_SETS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "StringHash.h"
+
+#if HASH_STRING_HASH != HASH_STRING_HASH_FNV1A || HASH_STRING_ID_BITS != 32
+#error "The crafted collision sets target 32 bit FNV-1a ids"
+#endif
+
+/** \brief Strings crafted against the intern table, what an attacker could build offline.
+ *  Both sets only need the public, unseeded StringID hash, 32 bit FNV-1a.
+ */
+namespace CollisionSets
+{
+	/// The multiplier unseeded tables place ids with, see InternTable's slotMultiplier()
+	std::uint64_t const kUnseededMultiplier = 0x9E3779B97F4A7C15ull;
+
+	/** \brief count strings whose ids share their home slot in unseeded tables of up to 2^bits slots.
+	  * Found by brute force: the top bits of id * multiplier pick the home
+	  * slot, so it takes about 2^bits hashes per string.
+	  */
+	inline std::vector< std::string > sharedHomeSlot( std::size_t count, unsigned bits )
+	{
+		std::vector< std::string > result;
+		std::uint64_t target = 0;
+		bool have_target = false;
+
+		for ( std::uint64_t n = 0; result.size() < count; ++n )
+		{
+			std::string const candidate = "slot" + std::to_string( n );
+			StringID const id = StringHash::hash( candidate.data(), candidate.size() );
+			std::uint64_t const home = ( static_cast< std::uint64_t >( id ) * kUnseededMultiplier ) >> ( 64 - bits );
+
+			if ( !have_target )
+			{
+				target = home;
+				have_target = true;
+			}
+
+			if ( home == target )
+			{
+				result.push_back( candidate );
+			}
+		}
+
+		return result;
+	}
+
+	/// FNV-1a 32 bit prime and its inverse mod 2^32, a step can be undone
+	std::uint32_t const kPrime = 16777619u;
+
+	inline std::uint32_t primeInverse()
+	{
+		// Newton's iteration, each step doubles the correct low bits
+		std::uint32_t inverse = kPrime;
+
+		for ( int i = 0; i < 5; ++i )
+		{
+			inverse *= 2u - kPrime * inverse;
+		}
+
+		return inverse;
+	}
+
+	/** \brief Up to count strings with the same 32 bit FNV-1a id as target, by meet in the middle.
+	  * Each string is one of 4 prefixes, 2 forward bytes and 3 backward
+	  * bytes, none of them 0.  The states after every prefix and forward
+	  * pair are kept sorted, the id is then undone through every 3 byte
+	  * suffix, and each state that meets a forward one is a string with
+	  * the target id.  About 1000 meet.
+	  */
+	inline std::vector< std::string > sameId( std::string const & target, std::size_t count )
+	{
+		StringID const target_id = StringHash::hash( target.data(), target.size() );
+		std::uint32_t const inverse = primeInverse();
+
+		// Forward state, prefix and forward bytes packed for sorting
+		std::vector< std::uint64_t > forward;
+		char const * const prefixes[] = { "mitm0/", "mitm1/", "mitm2/", "mitm3/" };
+
+		for ( std::uint32_t p = 0; p < 4; ++p )
+		{
+			std::uint32_t const prefix_state = StringHash::hash( prefixes[p], 6 );
+
+			for ( std::uint32_t b1 = 1; b1 < 256; ++b1 )
+			{
+				for ( std::uint32_t b2 = 1; b2 < 256; ++b2 )
+				{
+					std::uint32_t const state = ( ( prefix_state ^ b1 ) * kPrime ^ b2 ) * kPrime;
+
+					forward.push_back( std::uint64_t( state ) << 32 | p << 16 | b1 << 8 | b2 );
+				}
+			}
+		}
+
+		std::sort( forward.begin(), forward.end() );
+
+		// A bit per low 22 bits of a forward state, skips the search for most backward states
+		std::vector< std::uint64_t > seen( ( 1u << 22 ) / 64 );
+
+		for ( std::size_t i = 0; i < forward.size(); ++i )
+		{
+			std::uint32_t const low = static_cast< std::uint32_t >( forward[i] >> 32 ) & ( ( 1u << 22 ) - 1 );
+			seen[ low / 64 ] |= std::uint64_t( 1 ) << ( low % 64 );
+		}
+
+		std::vector< std::string > result;
+
+		for ( std::uint32_t c3 = 1; c3 < 256 && result.size() < count; ++c3 )
+		{
+			std::uint32_t const s2 = ( target_id * inverse ) ^ c3;
+
+			for ( std::uint32_t c2 = 1; c2 < 256 && result.size() < count; ++c2 )
+			{
+				std::uint32_t const s1 = ( s2 * inverse ) ^ c2;
+
+				for ( std::uint32_t c1 = 1; c1 < 256 && result.size() < count; ++c1 )
+				{
+					std::uint32_t const state = ( s1 * inverse ) ^ c1;
+					std::uint32_t const low = state & ( ( 1u << 22 ) - 1 );
+
+					if ( ( seen[ low / 64 ] >> ( low % 64 ) & 1 ) == 0 )
+					{
+						continue;
+					}
+
+					std::vector< std::uint64_t >::const_iterator found = std::lower_bound( forward.begin(), forward.end(), std::uint64_t( state ) << 32 );
+
+					for ( ; found != forward.end() && ( *found >> 32 ) == state && result.size() < count; ++found )
+					{
+						std::string str( prefixes[ ( *found >> 16 ) & 0xFF ] );
+						str += static_cast< char >( ( *found >> 8 ) & 0xFF );
+						str += static_cast< char >( *found & 0xFF );
+						str += static_cast< char >( c1 );
+						str += static_cast< char >( c2 );
+						str += static_cast< char >( c3 );
+
+						result.push_back( str );
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+}
+
+#endif
@@ -0,0 +1,92 @@
+/** \brief Interns crafted collision sets and checks every string keeps its own text.
+ *  - 2000 strings whose ids share one home slot in unseeded tables, which
+ *    makes every unseeded probe walk one long run.  Seeded tables place
+ *    them with a random multiplier, so they spread out.
+ *  - About 1000 strings with the StringID of "admin", each of which has
+ *    to move to a derived id.  With derived ids from the taken id alone,
+ *    they all walked one chain, and the 381st looped forever.
+ *  Built with HASH_STRING_RESOLVE_COLLISIONS, once unseeded and once with
+ *  HASH_STRING_SEEDED.  Prints how long each set took, which only shows
+ *  how the two compare, the checks are what pass or fail.
+ */
+
+#include "CollisionSets.h"
+#include "HashString.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	double millisecondsSince( Clock::time_point start )
+	{
+		return std::chrono::duration< double, std::milli >( Clock::now() - start ).count();
+	}
+
+	/// Interns strs, then checks each one is found, by text and by id, with its own text
+	void internAndCheck( char const * label, std::vector< std::string > const & strs )
+	{
+		std::vector< StringID > ids( strs.size() );
+
+		Clock::time_point start = Clock::now();
+
+		for ( std::size_t i = 0; i < strs.size(); ++i )
+		{
+			ids[i] = HashString::internString( strs[i].data(), strs[i].size() );
+		}
+
+		double const intern_ms = millisecondsSince( start );
+		start = Clock::now();
+
+		for ( std::size_t i = 0; i < strs.size(); ++i )
+		{
+			HashString found;
+
+			TEST_CHECK( HashString::tryFind( strs[i], found ) );
+			TEST_CHECK( found.getHashValue() == ids[i] );
+			TEST_CHECK( found.getString() == strs[i] );
+			TEST_CHECK( HashString::getStringFromHash( ids[i] ) == strs[i] );
+		}
+
+		double const lookup_ms = millisecondsSince( start );
+
+		// Distinct strings, so distinct ids
+		TEST_CHECK( std::set< StringID >( ids.begin(), ids.end() ).size() == strs.size() );
+
+		std::printf( "%-28s %5zu strings  intern %7.1f ms  lookup %7.1f ms\n", label, strs.size(), intern_ms, lookup_ms );
+	}
+}
+
+int main()
+{
+	std::printf( "%s\n", HASH_STRING_SEEDED ? "seeded" : "unseeded" );
+
+	// 2000 strings fill 2^12 slots to about half, and share a home slot at every size up to that
+	std::vector< std::string > const shared_slot = CollisionSets::sharedHomeSlot( 2000, 12 );
+	internAndCheck( "shared home slot", shared_slot );
+
+	std::string const admin( "admin" );
+	StringID const admin_id = HashString::internString( admin );
+	std::size_t const collisions_before = HashString::getCollisionCount();
+
+	std::vector< std::string > const same_id = CollisionSets::sameId( admin, 1000 );
+
+	// Well past the 381 strings the shared candidate chain could take
+	TEST_CHECK( same_id.size() > 512 );
+
+	for ( std::size_t i = 0; i < same_id.size(); ++i )
+	{
+		TEST_CHECK( StringHash::hash( same_id[i].data(), same_id[i].size() ) == admin_id );
+	}
+
+	internAndCheck( "same id as \"admin\"", same_id );
+
+	TEST_CHECK( HashString::getCollisionCount() - collisions_before == same_id.size() );
+	TEST_CHECK( HashString::getStringFromHash( admin_id ) == admin );
+
+	return TestCheck::exitCode();
+}
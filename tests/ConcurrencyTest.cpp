@@ -0,0 +1,250 @@
+/** \brief Interning and lock free lookups from several threads at once.
+ *  Writers intern names of their own and a shared set, in different
+ *  orders, while readers look names up by text, by id and by index, and
+ *  the main thread calls freeze() and forEachInterned() part way through.
+ *  Enough strings that every shard grows several times, so lookups run
+ *  while slot arrays are replaced and copied, and while indices are
+ *  published.  Every id and text has to round-trip, and a shared name has
+ *  to get the same id on every thread.
+ *
+ *  Built with HASH_STRING_THREAD_SAFE, with and without collision
+ *  resolution, and once with a single shard and the thread cache, which
+ *  puts every writer on one lock.  Labelled "threads", so a TSan build
+ *  can run just these with ctest -L threads.
+ */
+
+#include "HashString.h"
+#include "TestCheck.h"
+
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !HASH_STRING_THREAD_SAFE
+#error "ConcurrencyTest needs HASH_STRING_THREAD_SAFE"
+#endif
+
+namespace
+{
+	std::size_t const kWriters = 4;
+	std::size_t const kReaders = 2;
+
+	/// Names each writer interns alone, and names every writer interns
+	std::size_t const kOwn = 20000;
+	std::size_t const kShared = 5000;
+
+	std::string ownName( std::size_t writer, std::size_t i )
+	{
+		return "Writer" + std::to_string( writer ) + "/Mesh_" + std::to_string( i ) + ".material";
+	}
+
+	std::string sharedName( std::size_t i )
+	{
+		return "Shared/Mesh_" + std::to_string( i ) + ".material";
+	}
+
+	/// Strings interned so far by all writers, the main thread waits on it
+	std::atomic< std::size_t > s_progress( 0 );
+
+	std::atomic< bool > s_writing( true );
+
+	/** \brief Text interned under id, once the table has it.
+	  * An index is published before the insert that claimed it places it
+	  * in a slot, so a string reached by index may not be found by id
+	  * for a moment.  Hangs, and the test times out, if it never is.
+	  */
+	char const * textOnceFound( StringID id )
+	{
+		char const * text = HashString::getCStringFromHash( id );
+
+		while ( text == nullptr )
+		{
+			std::this_thread::yield();
+			text = HashString::getCStringFromHash( id );
+		}
+
+		return text;
+	}
+
+	/// Checks str round-trips through a handle interned from it
+	void checkHandle( HashString const & handle, std::string const & str )
+	{
+		TEST_CHECK( handle.getString() == str );
+
+		HashString found;
+
+		TEST_CHECK( HashString::tryFind( str, found ) );
+		TEST_CHECK( found.getHashValue() == handle.getHashValue() );
+		TEST_CHECK( found.getIndex() == handle.getIndex() );
+
+		char const * text = HashString::getCStringFromHash( handle.getHashValue() );
+
+		TEST_CHECK( text != nullptr && str == text );
+	}
+
+	struct Writer
+	{
+		std::size_t m_writer;
+		std::vector< StringID > m_own;
+		std::vector< StringID > m_shared;
+	};
+
+	void write( Writer * writer )
+	{
+		writer->m_own.resize( kOwn );
+		writer->m_shared.resize( kShared );
+
+		// Each writer walks the shared names from a different starting point
+		std::size_t const shared_start = writer->m_writer * kShared / kWriters;
+
+		for ( std::size_t i = 0; i < kOwn; ++i )
+		{
+			std::string const own = ownName( writer->m_writer, i );
+			HashString const handle( own );
+
+			checkHandle( handle, own );
+			writer->m_own[i] = handle.getHashValue();
+
+			if ( i % ( kOwn / kShared ) == 0 )
+			{
+				std::size_t const s = ( shared_start + i / ( kOwn / kShared ) ) % kShared;
+				std::string const shared = sharedName( s );
+				HashString const shared_handle( shared );
+
+				checkHandle( shared_handle, shared );
+				writer->m_shared[s] = shared_handle.getHashValue();
+			}
+
+			s_progress.fetch_add( 1, std::memory_order_relaxed );
+		}
+	}
+
+	/// Looks up random names and indices until the writers are done
+	void read( std::size_t reader )
+	{
+		std::uint32_t state = 1 + static_cast< std::uint32_t >( reader );
+
+		while ( s_writing.load( std::memory_order_acquire ) )
+		{
+			state = state * 1664525u + 1013904223u;
+
+			std::size_t const writer = ( state >> 8 ) % ( kWriters + 1 );
+			std::size_t const i = ( state >> 12 ) % kOwn;
+			std::string const name = writer == kWriters ? sharedName( i % kShared ) : ownName( writer, i );
+
+			// Not interned yet is fine, found has to be right
+			HashString found;
+
+			if ( HashString::tryFind( name, found ) )
+			{
+				TEST_CHECK( found.getString() == name );
+
+				char const * text = HashString::getCStringFromHash( found.getHashValue() );
+
+				TEST_CHECK( text != nullptr && name == text );
+			}
+
+			// Any index below the count is published, or about to be
+			std::size_t const count = HashString::getInternedCount();
+			HashString const interned = HashString::getInterned( static_cast< HashString::Index >( state % count ) );
+
+			TEST_CHECK( textOnceFound( interned.getHashValue() ) == interned.getCString() );
+		}
+	}
+
+	/// Waits until the writers have interned count strings
+	void waitFor( std::size_t count )
+	{
+		while ( s_progress.load( std::memory_order_relaxed ) < count )
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+int main()
+{
+	std::vector< Writer > writers( kWriters );
+	std::vector< std::thread > threads;
+
+	for ( std::size_t w = 0; w < kWriters; ++w )
+	{
+		writers[w].m_writer = w;
+		threads.push_back( std::thread( write, &writers[w] ) );
+	}
+
+	for ( std::size_t r = 0; r < kReaders; ++r )
+	{
+		threads.push_back( std::thread( read, r ) );
+	}
+
+	// Freeze a third of the way in, walk every string two thirds in, while the writers carry on
+	waitFor( kWriters * kOwn / 3 );
+	HashString::freeze();
+
+	waitFor( kWriters * kOwn * 2 / 3 );
+
+	std::size_t visited = 0;
+
+	HashString::forEachInterned( [ &visited ]( HashString const & interned )
+	{
+		TEST_CHECK( textOnceFound( interned.getHashValue() ) == interned.getCString() );
+		++visited;
+	} );
+
+	TEST_CHECK( visited >= kWriters * kOwn * 2 / 3 );
+
+	for ( std::size_t w = 0; w < kWriters; ++w )
+	{
+		threads[w].join();
+	}
+
+	s_writing.store( false, std::memory_order_release );
+
+	for ( std::size_t r = 0; r < kReaders; ++r )
+	{
+		threads[ kWriters + r ].join();
+	}
+
+	HashString::reclaim();
+
+	// Every thread got the same id for a shared name, and distinct strings got distinct ids
+	std::set< StringID > ids;
+
+	for ( std::size_t w = 0; w < kWriters; ++w )
+	{
+		for ( std::size_t s = 0; s < kShared; ++s )
+		{
+			TEST_CHECK( writers[w].m_shared[s] == writers[0].m_shared[s] );
+		}
+
+		ids.insert( writers[w].m_own.begin(), writers[w].m_own.end() );
+	}
+
+	ids.insert( writers[0].m_shared.begin(), writers[0].m_shared.end() );
+
+	TEST_CHECK( ids.size() == kWriters * kOwn + kShared );
+
+	// Plus the empty string
+	TEST_CHECK( HashString::getInternedCount() == kWriters * kOwn + kShared + 1 );
+
+	// Each shard grew from its first array more than once
+	TEST_CHECK( HashString::getGrowthStats().m_count > 2 * ShardedInternTable::kShardCount );
+
+	// Still found after reclaim()
+	for ( std::size_t w = 0; w < kWriters; ++w )
+	{
+		for ( std::size_t i = 0; i < kOwn; i += 97 )
+		{
+			std::string const own = ownName( w, i );
+			char const * text = HashString::getCStringFromHash( writers[w].m_own[i] );
+
+			TEST_CHECK( text != nullptr && own == text );
+		}
+	}
+
+	return TestCheck::exitCode();
+}
@@ -0,0 +1,97 @@
+/** \brief freeze() and reclaim() free what they replace, and lookups still work.
+ *  freeze() used to keep the slot array and frozen table it replaced,
+ *  so bytesReserved() rose with every freeze.  Single threaded builds
+ *  free them right away, HASH_STRING_THREAD_SAFE builds in reclaim().
+ *  Built once each way.
+ */
+
+#include "InternTable.h"
+#include "TestCheck.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	/// Interns count strings named prefix0, prefix1... and returns their ids
+	std::vector< StringID > internNames( InternTable & table, StringIndex & index, char const * prefix, std::size_t count )
+	{
+		std::vector< StringID > ids( count );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			std::string const name = prefix + std::to_string( i );
+
+			ids[i] = StringHash::hash( name.data(), name.size() );
+			table.insert( index, ids[i], name.data(), name.size() );
+		}
+
+		return ids;
+	}
+
+	/// Checks every string is found by id and by text, and an absent one is not
+	void checkFound( InternTable const & table, StringIndex const & index, char const * prefix, std::vector< StringID > const & ids )
+	{
+		for ( std::size_t i = 0; i < ids.size(); ++i )
+		{
+			std::string const name = prefix + std::to_string( i );
+			StringID id = StringHash::hash( name.data(), name.size() );
+
+			InternTable::Index const found = table.find( ids[i] );
+
+			TEST_CHECK( found != StringIndex::kNoIndex );
+			TEST_CHECK( table.find( index, id, name.data(), name.size() ) == found );
+			TEST_CHECK( id == ids[i] );
+		}
+
+		std::string const absent( "absent" );
+
+		TEST_CHECK( table.find( StringHash::hash( absent.data(), absent.size() ) ) == StringIndex::kNoIndex );
+	}
+}
+
+int main()
+{
+	StringIndex index( "", 0 );
+	InternTable table;
+
+	// One slot array, none being copied from, so the bytes compare the slots and the frozen table alone
+	table.reserve( 100000 );
+
+	std::vector< StringID > const first = internNames( table, index, "first", 100000 );
+	std::size_t const bytes_mutable = table.bytesReserved();
+
+	table.freeze();
+	table.reclaim();
+
+	std::size_t const bytes_frozen = table.bytesReserved();
+
+	// The frozen table takes less than the slot arrays it replaced
+	TEST_CHECK( bytes_frozen < bytes_mutable );
+	checkFound( table, index, "first", first );
+
+	// Strings after freeze() go to the overflow array, freezing again folds them in.  Too few to grow
+	// it, growing would free the arrays before it and hide a freeze() that keeps them
+	std::vector< StringID > const second = internNames( table, index, "second", 40 );
+
+	checkFound( table, index, "first", first );
+	checkFound( table, index, "second", second );
+
+	table.freeze();
+	table.freeze();
+	table.reclaim();
+
+	checkFound( table, index, "first", first );
+	checkFound( table, index, "second", second );
+
+	// Only the latest frozen table and an empty overflow array are left
+	TEST_CHECK( table.bytesReserved() < bytes_frozen + bytes_frozen / 8 );
+
+#if !HASH_STRING_THREAD_SAFE
+	// Freed without reclaim() too
+	table.freeze();
+	TEST_CHECK( table.bytesReserved() < bytes_frozen + bytes_frozen / 8 );
+#endif
+
+	return TestCheck::exitCode();
+}
@@ -0,0 +1,66 @@
+/** \brief reserve() with counts no table can hold, and a bad HASH_STRING_CAPACITY.
+ *  Counts past what 32 bit indices address used to overflow the slot
+ *  count, loop forever sizing it, or grow shards until memory ran out,
+ *  they have to throw std::length_error and leave the table as it was.
+ *  Built single threaded and with HASH_STRING_THREAD_SAFE's 64 shards.
+ *  ctest runs this with HASH_STRING_CAPACITY=-1, which strtoull() reads
+ *  as SIZE_MAX, so the first intern only works if it is ignored.
+ */
+
+#include "HashString.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+	/// True if reserve( count ) throws std::length_error
+	bool reserveThrows( std::size_t count )
+	{
+		try
+		{
+			HashString::reserve( count );
+		}
+		catch ( std::length_error const & )
+		{
+			return true;
+		}
+
+		return false;
+	}
+}
+
+int main()
+{
+	HashString const first( "first" );
+
+	TEST_CHECK( first.getString() == "first" );
+
+	std::size_t const growth_before = HashString::getGrowthStats().m_count;
+	std::size_t const max = std::numeric_limits< std::size_t >::max();
+
+	TEST_CHECK( reserveThrows( max ) );
+	TEST_CHECK( reserveThrows( max - 5 ) );
+	TEST_CHECK( reserveThrows( max / 2 ) );
+	TEST_CHECK( reserveThrows( std::size_t( std::numeric_limits< std::uint32_t >::max() ) * 2 ) );
+
+#if SIZE_MAX > 0xFFFFFFFFu
+	// Under the slot arrays' limit, but more strings than 32 bit indices number, so no shard may grow first
+	TEST_CHECK( reserveThrows( std::size_t( 1 ) << 32 ) );
+	TEST_CHECK( reserveThrows( 5000000000u ) );
+#endif
+
+	TEST_CHECK( HashString::getGrowthStats().m_count == growth_before );
+
+	// Still works after
+	HashString::reserve( 1000 );
+
+	HashString const second( "second" );
+
+	TEST_CHECK( second.getString() == "second" );
+	TEST_CHECK( HashString::getStringFromHash( first.getHashValue() ) == "first" );
+
+	return TestCheck::exitCode();
+}
@@ -0,0 +1,152 @@
+/** \brief The golden StringIDs, through the run time hashes.
+ *  StringHash.cpp only static_asserts them against hashConstexpr(), but
+ *  saved ids come from the run time code: hash(), the batch hash() with
+ *  its AVX2 kernel, the CRC32C instruction and table paths, and
+ *  store() / load().  Built once per HASH_STRING_HASH and id width.
+ */
+
+#include "StringHash.h"
+#include "TestCheck.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct Golden
+	{
+		char const * m_string;
+		StringID m_id;
+	};
+
+	// Same values as the README table and the static_asserts in StringHash.cpp
+	Golden const kGolden[] =
+	{
+#if HASH_STRING_HASH == HASH_STRING_HASH_FNV1A && HASH_STRING_ID_BITS == 64
+		{ "", 0xCBF29CE484222325ull },
+		{ "a", 0xAF63DC4C8601EC8Cull },
+		{ "123456789", 0x06D5573923C6CDFCull },
+		{ "The quick brown fox jumps over the lazy dog", 0xF3F9B7F5E7E47110ull },
+#elif HASH_STRING_HASH == HASH_STRING_HASH_FNV1A
+		{ "", 0x811C9DC5u },
+		{ "a", 0xE40C292Cu },
+		{ "123456789", 0xBB86B11Cu },
+		{ "The quick brown fox jumps over the lazy dog", 0x048FFF90u },
+#elif HASH_STRING_HASH == HASH_STRING_HASH_XXHASH && HASH_STRING_ID_BITS == 64
+		{ "", 0xEF46DB3751D8E999ull },
+		{ "a", 0xD24EC4F1A98C6E5Bull },
+		{ "123456789", 0x8CB841DB40E6AE83ull },
+		{ "The quick brown fox jumps over the lazy dog", 0x0B242D361FDA71BCull },
+#elif HASH_STRING_HASH == HASH_STRING_HASH_XXHASH
+		{ "", 0x02CC5D05u },
+		{ "a", 0x550D7456u },
+		{ "123456789", 0x937BAD67u },
+		{ "The quick brown fox jumps over the lazy dog", 0xE85EA4DEu },
+#elif HASH_STRING_HASH == HASH_STRING_HASH_CRC32C
+		{ "", 0x00000000u },
+		{ "a", 0xC1D04330u },
+		{ "123456789", 0xE3069283u },
+		{ "The quick brown fox jumps over the lazy dog", 0x22620404u },
+#endif
+	};
+
+	std::size_t const kGoldenCount = sizeof( kGolden ) / sizeof( kGolden[0] );
+
+	void checkScalar()
+	{
+		for ( std::size_t i = 0; i < kGoldenCount; ++i )
+		{
+			std::string const str( kGolden[i].m_string );
+
+			TEST_CHECK( StringHash::hash( str.data(), str.size() ) == kGolden[i].m_id );
+
+#if HASH_STRING_HASH == HASH_STRING_HASH_CRC32C
+			TEST_CHECK( Crc32cHash::hashTable( str.data(), str.size() ) == kGolden[i].m_id );
+#endif
+		}
+	}
+
+	void checkBatch()
+	{
+		// Enough strings for several full groups of vector lanes, the golden ones mixed in at every lane
+		std::size_t const count = 16 * 4 + 3;
+		std::vector< std::string > strs( count );
+		std::vector< char const * > pointers( count );
+		std::vector< std::size_t > lengths( count );
+		std::vector< StringID > ids( count );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			strs[i] = kGolden[ ( i * 3 + i / 16 ) % kGoldenCount ].m_string;
+			pointers[i] = strs[i].data();
+			lengths[i] = strs[i].size();
+		}
+
+		StringHash::hash( pointers.data(), lengths.data(), count, ids.data() );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			TEST_CHECK( ids[i] == kGolden[ ( i * 3 + i / 16 ) % kGoldenCount ].m_id );
+		}
+
+		// Lengths from 0 to 300 take every masking and tail path, each must match hashConstexpr()
+		std::size_t const random_count = 301;
+		std::uint32_t state = 12345;
+
+		strs.assign( random_count, std::string() );
+		pointers.resize( random_count );
+		lengths.resize( random_count );
+		ids.resize( random_count );
+
+		for ( std::size_t i = 0; i < random_count; ++i )
+		{
+			strs[i].resize( ( i * 7 ) % random_count );
+
+			for ( std::size_t c = 0; c < strs[i].size(); ++c )
+			{
+				state = state * 1664525u + 1013904223u;
+				strs[i][c] = static_cast< char >( state >> 24 );
+			}
+
+			pointers[i] = strs[i].data();
+			lengths[i] = strs[i].size();
+		}
+
+		StringHash::hash( pointers.data(), lengths.data(), random_count, ids.data() );
+
+		for ( std::size_t i = 0; i < random_count; ++i )
+		{
+			TEST_CHECK( ids[i] == StringHash::hashConstexpr( pointers[i], lengths[i] ) );
+			TEST_CHECK( ids[i] == StringHash::hash( pointers[i], lengths[i] ) );
+		}
+	}
+
+	void checkStoreLoad()
+	{
+		for ( std::size_t i = 0; i < kGoldenCount; ++i )
+		{
+			unsigned char bytes[ StringHash::kIdBytes ];
+			StringHash::store( kGolden[i].m_id, bytes );
+
+			// Least significant byte first
+			StringID rest = kGolden[i].m_id;
+
+			for ( std::size_t b = 0; b < StringHash::kIdBytes; ++b )
+			{
+				TEST_CHECK( bytes[b] == rest % 256 );
+				rest /= 256;
+			}
+
+			TEST_CHECK( StringHash::load( bytes ) == kGolden[i].m_id );
+		}
+	}
+}
+
+int main()
+{
+	checkScalar();
+	checkBatch();
+	checkStoreLoad();
+
+	return TestCheck::exitCode();
+}
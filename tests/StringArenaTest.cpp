@@ -0,0 +1,66 @@
+/** \brief StringArena records round-trip, and lengths past 32 bits throw.
+ *  A record keeps its length in 32 bits, so store() used to cut a string
+ *  of 4 GiB or more to its low bits and hand back a short string.  Such
+ *  lengths have to throw std::length_error before anything is allocated
+ *  or copied, which lets this pass them with a small buffer.
+ */
+
+#include "StringArena.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	/// True if store() throws std::length_error for length, with nothing stored
+	bool storeThrows( StringArena & arena, std::size_t length )
+	{
+		std::size_t const reserved = arena.bytesReserved();
+		std::size_t const used = arena.bytesUsed();
+
+		try
+		{
+			arena.store( "x", length );
+		}
+		catch ( std::length_error const & )
+		{
+			return arena.bytesReserved() == reserved && arena.bytesUsed() == used;
+		}
+
+		return false;
+	}
+}
+
+int main()
+{
+	StringArena arena;
+
+	// Small records share a page, large ones get their own
+	std::string const small( "Entity/Component/Mesh_0.material" );
+	std::string const large( 100000, 'a' );
+
+	char const * stored_small = arena.store( small.data(), small.size(), 1234 );
+	char const * stored_large = arena.store( large.data(), large.size(), 5678 );
+	char const * stored_empty = arena.store( "", 0 );
+
+	TEST_CHECK( small == stored_small && StringArena::length( stored_small ) == small.size() );
+	TEST_CHECK( StringArena::check( stored_small ) == 1234 );
+	TEST_CHECK( large == stored_large && StringArena::length( stored_large ) == large.size() );
+	TEST_CHECK( StringArena::check( stored_large ) == 5678 );
+	TEST_CHECK( *stored_empty == '\0' && StringArena::length( stored_empty ) == 0 );
+
+#if SIZE_MAX > 0xFFFFFFFFu
+	TEST_CHECK( storeThrows( arena, StringArena::kMaxLength + 1 ) );
+	TEST_CHECK( storeThrows( arena, std::size_t( 5 ) << 32 ) );
+	TEST_CHECK( storeThrows( arena, SIZE_MAX ) );
+#endif
+
+	// Still works after
+	char const * after = arena.store( small.data(), small.size() );
+
+	TEST_CHECK( small == after && StringArena::length( after ) == small.size() );
+
+	return TestCheck::exitCode();
+}
@@ -0,0 +1,43 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <atomic>
+#include <cstdio>
+
+/** \brief Minimal checks for the tests, no framework.
+ *  TEST_CHECK prints the failed condition with its location and counts
+ *  it, and a test's main() returns TestCheck::exitCode(), so ctest sees
+ *  every failure of a run rather than only the first.
+ */
+namespace TestCheck
+{
+	/// Failed checks so far, atomic so checks may fail on any thread
+	inline std::atomic< int > & failures()
+	{
+		static std::atomic< int > s_failures( 0 );
+
+		return s_failures;
+	}
+
+	inline void fail( char const * condition, char const * file, int line )
+	{
+		std::printf( "%s:%d: check failed: %s\n", file, line, condition );
+		++failures();
+	}
+
+	/// 0 when every check passed
+	inline int exitCode()
+	{
+		if ( failures() != 0 )
+		{
+			std::printf( "%d checks failed\n", failures().load() );
+		}
+
+		return failures() == 0 ? 0 : 1;
+	}
+}
+
+#define TEST_CHECK( condition ) \
+	( ( condition ) ? ( void )0 : TestCheck::fail( #condition, __FILE__, __LINE__ ) )
+
+#endif